@@ -0,0 +1,143 @@
+// Arena (bump) allocator
+// Blocks are chained; a request that does not fit starts a new block.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "arena.h"
+
+#define ARENA_ALIGN      16
+#define SESSION_BLOCK    (1 << 20)
+#define REQUEST_BLOCK    (4 << 20)
+
+struct arena_block {
+    arena_block *next;
+    size_t       size, used;
+    // data follows, ARENA_ALIGN aligned
+};
+
+#define BLOCK_HEADER ((sizeof(arena_block) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+arena_t session_arena = ARENA_INIT(SESSION_BLOCK);
+arena_t request_arena = ARENA_INIT(REQUEST_BLOCK);
+
+void arena_init(arena_t *a, size_t block_size)
+{
+    memset(a, 0, sizeof(*a));
+    a->block_size = block_size;
+}
+
+void *arena_alloc(arena_t *a, size_t size)
+{
+    arena_block *b = a->head;
+
+    // the rounded size and the block header must not wrap around
+    if (size > SIZE_MAX - BLOCK_HEADER - ARENA_ALIGN) return NULL;
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    if (!b || b->size - b->used < size) {
+        size_t bytes = (size > a->block_size) ? size : a->block_size;
+        b = malloc(BLOCK_HEADER + bytes);
+        if (!b) return NULL;
+        b->next = a->head;
+        b->size = bytes;
+        b->used = 0;
+        a->head = b;
+        a->reserved += bytes;
+        a->blocks++;
+    }
+
+    b->used += size;
+    a->in_use += size;
+    a->total += size;
+    if (a->in_use > a->peak) a->peak = a->in_use;
+    return (char *)b + BLOCK_HEADER + b->used - size;
+}
+
+char *arena_strdup(arena_t *a, const char *s, size_t len)
+{
+    char *p = arena_alloc(a, len + 1);
+    if (!p) return NULL;
+    memcpy(p, s, len);
+    p[len] = '\0';
+    return p;
+}
+
+// Frees blocks newer than keep (keep stays)
+static void arena_drop_to(arena_t *a, arena_block *keep)
+{
+    while (a->head && a->head != keep) {
+        arena_block *next = a->head->next;
+        a->reserved -= a->head->size;
+        a->blocks--;
+        free(a->head);
+        a->head = next;
+    }
+}
+
+// Keeps the oldest block for reuse and frees the rest
+void arena_reset(arena_t *a)
+{
+    arena_block *oldest = a->head;
+
+    if (!oldest) return;
+    while (oldest->next) oldest = oldest->next;
+    arena_drop_to(a, oldest);
+    oldest->used = 0;
+    a->in_use = 0;
+}
+
+void arena_free(arena_t *a)
+{
+    arena_drop_to(a, NULL);
+    a->in_use = 0;
+}
+
+arena_mark_t arena_mark(const arena_t *a)
+{
+    arena_mark_t m;
+    m.block  = a->head;
+    m.used   = a->head ? a->head->used : 0;
+    m.in_use = a->in_use;
+    return m;
+}
+
+void arena_release(arena_t *a, arena_mark_t mark)
+{
+    if (!mark.block) {
+        arena_reset(a);
+        return;
+    }
+    arena_drop_to(a, mark.block);
+    mark.block->used = mark.used;
+    a->in_use = mark.in_use;
+}
+
+void arena_print_stats(const arena_t *a, const char *name)
+{
+    fprintf(stderr, "%s arena: in use %zu B, peak %zu B, allocated %zu B, "
+            "reserved %zu B in %d block(s)\n",
+            name, a->in_use, a->peak, a->total, a->reserved, a->blocks);
+}
+
+void *pool_get(pool_t *p)
+{
+    void *buf = p->free_list;
+
+    if (buf) {
+        p->free_list = *(void **)buf;
+        p->reused++;
+        return buf;
+    }
+    buf = arena_alloc(p->arena, p->size > sizeof(void *) ? p->size : sizeof(void *));
+    if (buf) p->created++;
+    return buf;
+}
+
+void pool_put(pool_t *p, void *buf)
+{
+    if (!buf) return;
+    *(void **)buf = p->free_list;
+    p->free_list = buf;
+}
@@ -0,0 +1,65 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Arena (bump) allocator
+// Memory is handed out from large blocks and released all at once with
+// arena_reset() or arena_free(), so there is no per-object free().
+// Compute kernels never allocate: callers size their buffers from an
+// arena before the loop and release them afterwards.
+
+typedef struct arena_block arena_block;
+
+typedef struct {
+    arena_block *head;        // current block (older blocks are chained)
+    size_t       block_size;  // default size of new blocks
+
+    // Statistics
+    size_t       in_use;      // bytes handed out and not yet released
+    size_t       peak;        // highest in_use seen
+    size_t       total;       // bytes handed out since the arena was created
+    size_t       reserved;    // bytes obtained from malloc for blocks
+    int          blocks;      // blocks currently held
+} arena_t;
+
+#define ARENA_INIT(block_size) { NULL, (block_size), 0, 0, 0, 0, 0 }
+
+// Position to roll back to with arena_release()
+typedef struct {
+    arena_block *block;
+    size_t       used;
+    size_t       in_use;
+} arena_mark_t;
+
+void  arena_init(arena_t *a, size_t block_size);
+void *arena_alloc(arena_t *a, size_t size);    // 16-byte aligned, NULL if out of memory
+char *arena_strdup(arena_t *a, const char *s, size_t len);
+void  arena_reset(arena_t *a);                 // drop all allocations
+void  arena_free(arena_t *a);                  // also return blocks to the system
+
+arena_mark_t arena_mark(const arena_t *a);
+void  arena_release(arena_t *a, arena_mark_t mark);  // drop allocations after mark
+
+void  arena_print_stats(const arena_t *a, const char *name);   // to stderr
+
+// Shared arenas
+// session_arena lives for the whole run, request_arena is reset after every
+// menu action and subcommand
+extern arena_t session_arena;
+extern arena_t request_arena;
+
+// Pool of equal-sized buffers carved from an arena and recycled
+typedef struct {
+    arena_t *arena;
+    size_t   size;
+    void    *free_list;
+    int      created, reused;
+} pool_t;
+
+#define POOL_INIT(arena, size) { (arena), (size), NULL, 0, 0 }
+
+void *pool_get(pool_t *p);
+void  pool_put(pool_t *p, void *buf);
+
+#endif
@@ -0,0 +1,266 @@
+// Color band recognition
+// 1. Every pixel is classified through a 32x32x32 RGB lookup cube that
+//    holds the nearest reference color in CIE Lab (built once).
+// 2. The body axis is the mean row of the pixels classified as body.
+// 3. A strip of rows around the axis is averaged into one color per
+//    column (a straight add loop over bytes that the compiler vectorizes)
+//    and each column is classified through the cube again.
+// 4. Between the first and last body column, every run of non-body
+//    columns wider than the noise threshold is a band; its color is the
+//    majority class of the run.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include "funcs.h"
+#include "arena.h"
+#include "bandscan.h"
+#include "marking.h"
+
+#define CUBE_BITS   5
+#define CUBE_SIZE   (1 << CUBE_BITS)
+#define CLASS_BODY  12
+#define SCAN_MAX_BANDS 6
+
+// Reference colors as they typically photograph, index = color index,
+// then the two common body colors (beige carbon film, blue metal film)
+static const unsigned char ref_rgb[][3] = {
+    {  20,  20,  20 }, { 101,  67,  33 }, { 200,  30,  30 }, { 255, 140,   0 },
+    { 255, 215,   0 }, {   0, 140,  60 }, {  30,  60, 200 }, { 140,  60, 170 },
+    { 128, 128, 128 }, { 240, 240, 240 }, { 200, 165,  70 }, { 192, 192, 192 },
+    { 215, 190, 145 }, { 120, 170, 220 },
+};
+
+#define REF_COUNT (int)(sizeof(ref_rgb) / sizeof(ref_rgb[0]))
+
+static unsigned char lab_cube[CUBE_SIZE * CUBE_SIZE * CUBE_SIZE];
+static int           cube_ready;
+
+#define CUBE_INDEX(r, g, b) \
+    ((((r) >> (8 - CUBE_BITS)) << (2 * CUBE_BITS)) | (((g) >> (8 - CUBE_BITS)) << CUBE_BITS) | \
+     ((b) >> (8 - CUBE_BITS)))
+
+static double srgb_linear(double c)
+{
+    c /= 255.0;
+    return (c <= 0.04045) ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4);
+}
+
+static double lab_f(double t)
+{
+    return (t > 216.0 / 24389.0) ? cbrt(t) : (24389.0 / 27.0 * t + 16.0) / 116.0;
+}
+
+// sRGB (D65) to CIE Lab
+static void rgb_to_lab(double r, double g, double b, double lab[3])
+{
+    double R = srgb_linear(r), G = srgb_linear(g), B = srgb_linear(b);
+    double x = (0.4124 * R + 0.3576 * G + 0.1805 * B) / 0.95047;
+    double y = (0.2126 * R + 0.7152 * G + 0.0722 * B);
+    double z = (0.0193 * R + 0.1192 * G + 0.9505 * B) / 1.08883;
+
+    lab[0] = 116.0 * lab_f(y) - 16.0;
+    lab[1] = 500.0 * (lab_f(x) - lab_f(y));
+    lab[2] = 200.0 * (lab_f(y) - lab_f(z));
+}
+
+// Nearest reference for the center of every cube cell. Lightness counts
+// half so uneven lighting moves fewer colors into the wrong class.
+static void build_cube(void)
+{
+    double ref[REF_COUNT][3], lab[3];
+    int r, g, b, k;
+
+    for (k = 0; k < REF_COUNT; k++) rgb_to_lab(ref_rgb[k][0], ref_rgb[k][1], ref_rgb[k][2], ref[k]);
+
+    for (r = 0; r < CUBE_SIZE; r++)
+        for (g = 0; g < CUBE_SIZE; g++)
+            for (b = 0; b < CUBE_SIZE; b++) {
+                double best = 1e30;
+                int cls = 0, step = 256 / CUBE_SIZE;
+
+                rgb_to_lab(r * step + step / 2, g * step + step / 2, b * step + step / 2, lab);
+                for (k = 0; k < REF_COUNT; k++) {
+                    double dl = (lab[0] - ref[k][0]) / 2, da = lab[1] - ref[k][1], db = lab[2] - ref[k][2];
+                    double d = dl * dl + da * da + db * db;
+                    if (d < best) { best = d; cls = k; }
+                }
+                lab_cube[(r << (2 * CUBE_BITS)) | (g << CUBE_BITS) | b] =
+                    (unsigned char)(cls >= CLASS_BODY ? CLASS_BODY : cls);
+            }
+    cube_ready = 1;
+}
+
+// ---- PPM ----
+
+// Next header number, skipping whitespace and # comments
+static int ppm_number(FILE *fp, int *out)
+{
+    int c = fgetc(fp), v = 0, digits = 0;
+
+    for (;;) {
+        while (c != EOF && isspace(c)) c = fgetc(fp);
+        if (c != '#') break;
+        while (c != EOF && c != '\n') c = fgetc(fp);
+    }
+    while (c != EOF && isdigit(c)) {
+        v = v * 10 + (c - '0');
+        if (v > 1 << 20) return -1;
+        digits++;
+        c = fgetc(fp);
+    }
+    if (!digits || c == EOF || !isspace(c)) return -1;   // one whitespace ends the header
+    *out = v;
+    return 0;
+}
+
+int ppm_read(FILE *fp, arena_t *a, image_t *img)
+{
+    int c, maxval;
+    size_t bytes;
+
+    do c = fgetc(fp); while (c != EOF && isspace(c));
+    if (c == EOF) return 1;
+    if (c != 'P' || fgetc(fp) != '6') return -1;
+
+    if (ppm_number(fp, &img->w) != 0 || ppm_number(fp, &img->h) != 0 ||
+        ppm_number(fp, &maxval) != 0 || maxval != 255 || img->w < 1 || img->h < 1)
+        return -1;
+
+    bytes = (size_t)img->w * img->h * 3;
+    img->rgb = arena_alloc(a, bytes);
+    if (!img->rgb || fread(img->rgb, 1, bytes, fp) != bytes) return -1;
+    return 0;
+}
+
+// ---- Segmentation ----
+
+int scan_bands(const image_t *img, int bands[], int max_bands)
+{
+    const int w = img->w, h = img->h;
+    arena_mark_t mark = arena_mark(&request_arena);
+    unsigned *sum = arena_alloc(&request_arena, sizeof(unsigned) * 3 * w);
+    unsigned char *cls = arena_alloc(&request_arena, (size_t)w);
+    double rows_weighted = 0.0, body_pixels = 0.0;
+    int x, y, axis, half, y0, y1, first, last, n = 0;
+
+    if (!sum || !cls) { arena_release(&request_arena, mark); return 0; }
+    if (!cube_ready) build_cube();
+
+    // 1-2. body axis from every 4th row and column
+    for (y = 0; y < h; y += 4) {
+        const unsigned char *p = img->rgb + (size_t)y * w * 3;
+        int count = 0;
+        for (x = 0; x < w; x += 4, p += 12)
+            count += (lab_cube[CUBE_INDEX(p[0], p[1], p[2])] == CLASS_BODY);
+        rows_weighted += (double)count * y;
+        body_pixels += count;
+    }
+    if (body_pixels == 0.0) { arena_release(&request_arena, mark); return 0; }
+    axis = (int)(rows_weighted / body_pixels + 0.5);
+
+    // 3. average a strip around the axis into one color per column
+    half = h / 40 > 1 ? h / 40 : 1;
+    y0 = axis - half > 0 ? axis - half : 0;
+    y1 = axis + half < h - 1 ? axis + half : h - 1;
+    memset(sum, 0, sizeof(unsigned) * 3 * w);
+    for (y = y0; y <= y1; y++) {
+        const unsigned char *p = img->rgb + (size_t)y * w * 3;
+        for (x = 0; x < 3 * w; x++) sum[x] += p[x];
+    }
+    for (x = 0; x < w; x++) {
+        unsigned rows = (unsigned)(y1 - y0 + 1);
+        cls[x] = lab_cube[CUBE_INDEX(sum[3 * x] / rows, sum[3 * x + 1] / rows, sum[3 * x + 2] / rows)];
+    }
+
+    // 4. non-body runs between the body ends
+    for (first = 0; first < w && cls[first] != CLASS_BODY; first++) {}
+    for (last = w - 1; last > first && cls[last] != CLASS_BODY; last--) {}
+
+    for (x = first; x <= last && n < max_bands; ) {
+        int start = x, votes[CLASS_BODY] = { 0 }, best = 0, k;
+
+        if (cls[x] == CLASS_BODY) { x++; continue; }
+        while (x <= last && cls[x] != CLASS_BODY) votes[cls[x++]]++;
+
+        // runs narrower than 1/40 of the body are edges or glare
+        if ((x - start) * 40 < last - first) continue;
+        for (k = 1; k < CLASS_BODY; k++) if (votes[k] > votes[best]) best = k;
+        bands[n++] = best;
+    }
+
+    // the tolerance band (gold/silver) is read last
+    if (n > 1 && bands[0] >= 10 && bands[n - 1] < 10) {
+        int i;
+        for (i = 0; i < n / 2; i++) {
+            int t = bands[i];
+            bands[i] = bands[n - 1 - i];
+            bands[n - 1 - i] = t;
+        }
+    }
+
+    arena_release(&request_arena, mark);
+    return n;
+}
+
+// ---- Command ----
+
+// Ohms for the recognized bands, -1 if they are not a valid code
+static double scan_value(const int b[], int n)
+{
+    unsigned char code[SCAN_MAX_BANDS];
+    marking_result r;
+    int i;
+
+    for (i = 0; i < n; i++) code[i] = (unsigned char)b[i];
+    return (marking_decode_codes(&mk_resistor, code, n, &r) == 0) ? r.value : -1.0;
+}
+
+static int scan_stream(FILE *fp, const char *name, int *frame)
+{
+    image_t img;
+    int bands[SCAN_MAX_BANDS], n, i, status;
+
+    for (;;) {
+        arena_mark_t mark = arena_mark(&request_arena);
+        double R;
+
+        status = ppm_read(fp, &request_arena, &img);
+        if (status != 0) {
+            arena_release(&request_arena, mark);
+            if (status < 0) fprintf(stderr, "scan: %s: not a P6 PPM frame\n", name);
+            return status < 0 ? -1 : 0;
+        }
+
+        n = scan_bands(&img, bands, SCAN_MAX_BANDS);
+        printf("%d:", (*frame)++);
+        for (i = 0; i < n; i++) printf(" %s", color_name(bands[i]));
+        R = scan_value(bands, n);
+        if (R >= 0.0) printf(" = %.6g ohm", R);
+        else printf(" (no valid code)");
+        printf("\n");
+
+        arena_release(&request_arena, mark);
+    }
+}
+
+int scan_main(int argc, char *argv[])
+{
+    int i, frame = 0, status = 0;
+
+    if (argc == 1) return scan_stream(stdin, "stdin", &frame) == 0 ? 0 : 1;
+
+    for (i = 1; i < argc; i++) {
+        FILE *fp = fopen(argv[i], "rb");
+        if (!fp) {
+            fprintf(stderr, "scan: cannot read '%s'\n", argv[i]);
+            status = 1;
+            continue;
+        }
+        if (scan_stream(fp, argv[i], &frame) != 0) status = 1;
+        fclose(fp);
+    }
+    return status;
+}
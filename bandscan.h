@@ -0,0 +1,28 @@
+#ifndef BANDSCAN_H
+#define BANDSCAN_H
+
+#include <stdio.h>
+#include "arena.h"
+
+// Color band recognition from images
+// "main.out scan [frame.ppm ...]" reads binary PPM (P6) frames, from the
+// files given or as a concatenated stream on stdin, and prints the bands
+// and resistance of the resistor in each frame. The resistor is expected
+// to lie roughly horizontally across the frame, as on a reel camera.
+
+typedef struct {
+    int            w, h;
+    unsigned char *rgb;    // w * h * 3 bytes, row by row
+} image_t;
+
+// Reads the next P6 frame from fp into arena memory
+// Returns 0 on success, 1 at end of stream, -1 on a malformed frame
+int ppm_read(FILE *fp, arena_t *a, image_t *img);
+
+// Band color indices (as color_name()) from left to right in reading
+// order, returns the number of bands found (at most max_bands)
+int scan_bands(const image_t *img, int bands[], int max_bands);
+
+int scan_main(int argc, char *argv[]);
+
+#endif
@@ -0,0 +1,377 @@
+// Batch (CSV) mode
+// The input file is read whole into the request arena, parsed into
+// columns once, run through the batch kernels in funcs.c and formatted
+// into a pooled output buffer. Nothing is allocated per row. The kernels
+// run on the shared work-stealing scheduler in chunks of BATCH_GRAIN rows.
+// With --numa the columns are placed by first touch and processed on a
+// static partition by pinned workers (compact unless --pin is given), so
+// each worker reads memory on its own node.
+// The per-row kernels are independent of how rows are split; --sum adds
+// a reduction over the result column that can be made bit-reproducible
+// with --deterministic (see reduce.h).
+// Rows are computed and written in segments of BATCH_SEGMENT rows. With
+// --journal a checkpoint is posted after each segment (see journal.h) and
+// a rerun of the same input and options continues after the last one.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "funcs.h"
+#include "arena.h"
+#include "textio.h"
+#include "batch.h"
+#include "scheduler.h"
+#include "topology.h"
+#include "reduce.h"
+#include "eseries.h"
+#include "journal.h"
+
+#define BATCH_GRAIN   4096
+#define BATCH_SEGMENT (1024 * 1024)   // rows per checkpoint
+#define LED_RATING  0.25     // W, when the rating column is blank
+
+typedef struct {
+    const char *name;
+    int         cols;     // fixed column count, 0 = any number per row
+    const char *input;    // expected input columns (for usage)
+    const char *header;   // output header line
+} batch_kind;
+
+enum { BATCH_SERIES, BATCH_PARALLEL, BATCH_RC, BATCH_RC_DISCHARGE, BATCH_OHM, BATCH_LED };
+
+static const batch_kind batch_kinds[] = {
+    { "series",       0, "R1,R2,...", "R_total" },
+    { "parallel",     0, "R1,R2,...", "R_total" },
+    { "rc",           4, "R,C,V,t",   "Vc" },
+    { "rc-discharge", 4, "R,C,V0,t",  "Vc" },
+    { "ohm",          4, "V,I,R,P (two known, others blank)", "V,I,R,P" },
+    { "led",          4, "Vs,Vf,I,P_rating (rating blank = 0.25 W)", "R,R_std,I,P,over" },
+};
+
+#define BATCH_KIND_COUNT (int)(sizeof(batch_kinds) / sizeof(batch_kinds[0]))
+
+static void batch_usage(void)
+{
+    int i;
+    fprintf(stderr, "Usage: main.out batch <kind> <in.csv> [-o out.csv] [--threads N]\n"
+                    "                      [--numa] [--pin none|compact|spread] [--stats]\n"
+                    "                      [--sum] [--deterministic] [--series E24]\n"
+                    "                      [--journal run.jnl]   (needs -o, resumes a stopped run)\n");
+    for (i = 0; i < BATCH_KIND_COUNT; i++)
+        fprintf(stderr, "  %-13s columns %s\n", batch_kinds[i].name, batch_kinds[i].input);
+}
+
+// Work for the copy and compute passes
+typedef struct {
+    int                 kind, ncols;
+    int                 series;   // E-series for led
+    const textio_table *t;        // parsed input
+    const double       *values;   // row values read by the kernels
+    double             *copy;     // NUMA copy of t->values (row kinds only)
+    double             *col[4];   // fixed-width kinds: one array per column
+    double             *out;
+    double             *res[3];   // further result columns (led)
+} batch_job;
+
+// Allocations placed with first touch (NUMA mode), unmapped at the end
+typedef struct {
+    void  *p;
+    size_t bytes;
+} batch_mapping;
+
+static batch_mapping mappings[8];
+static int           nmappings;
+
+static double *batch_alloc(size_t n, int numa)
+{
+    size_t bytes = sizeof(double) * (n > 0 ? n : 1);
+    double *p;
+
+    if (!numa || nmappings == (int)(sizeof(mappings) / sizeof(mappings[0])))
+        return arena_alloc(&request_arena, bytes);
+
+    p = topo_alloc(bytes);
+    if (p) {
+        mappings[nmappings].p = p;
+        mappings[nmappings++].bytes = bytes;
+    }
+    return p;
+}
+
+static void batch_unmap(void)
+{
+    while (nmappings > 0) {
+        nmappings--;
+        topo_free(mappings[nmappings].p, mappings[nmappings].bytes);
+    }
+}
+
+// Copies rows [lo, hi) into the kernel inputs. In NUMA mode this runs on
+// the same static partition as the compute pass, so every page is first
+// touched by the worker that later reads it.
+static void batch_copy_chunk(size_t lo, size_t hi, void *arg)
+{
+    batch_job *j = arg;
+    const textio_table *t = j->t;
+    size_t r;
+    int c;
+
+    if (!j->ncols) {
+        if (j->copy) {
+            size_t first = t->row_start[lo], last = t->row_start[hi];
+            memcpy(j->copy + first, t->values + first, sizeof(double) * (last - first));
+        }
+        return;
+    }
+    for (r = lo; r < hi; r++) {
+        const double *row = &t->values[t->row_start[r]];
+        for (c = 0; c < j->ncols; c++) j->col[c][r] = row[c];
+    }
+}
+
+// Runs the kernel on rows [lo, hi), row_start holds absolute offsets so
+// the row kernels only need shifted row_start/out pointers
+static void batch_chunk(size_t lo, size_t hi, void *arg)
+{
+    const batch_job *j = arg;
+    double *const *col = j->col;
+    int n = (int)(hi - lo);
+
+    switch (j->kind) {
+    case BATCH_SERIES:
+        series_rows(j->values, j->t->row_start + lo, n, j->out + lo);
+        break;
+    case BATCH_PARALLEL:
+        parallel_rows(j->values, j->t->row_start + lo, n, j->out + lo);
+        break;
+    case BATCH_RC:
+        rc_charge_batch(col[0] + lo, col[1] + lo, col[2] + lo, col[3] + lo, j->out + lo, n);
+        break;
+    case BATCH_RC_DISCHARGE:
+        rc_discharge_batch(col[0] + lo, col[1] + lo, col[2] + lo, col[3] + lo, j->out + lo, n);
+        break;
+    case BATCH_OHM:
+        ohm_batch(col[0] + lo, col[1] + lo, col[2] + lo, col[3] + lo, n);
+        break;
+    case BATCH_LED:
+        led_batch(col[0] + lo, col[1] + lo, col[2] + lo, j->series,
+                  j->out + lo, j->res[0] + lo, j->res[1] + lo, j->res[2] + lo, n);
+        break;
+    }
+}
+
+// Formats rows [lo, hi) of the results
+static void batch_write_rows(const batch_job *job, size_t lo, size_t hi, textio_out *o)
+{
+    size_t r;
+
+    for (r = lo; r < hi; r++) {
+        if (job->kind == BATCH_OHM) {
+            textio_printf(o, "%.9g,%.9g,%.9g,%.9g\n",
+                          job->col[0][r], job->col[1][r], job->col[2][r], job->col[3][r]);
+        } else if (job->kind == BATCH_LED) {
+            double rating = job->col[3][r] > 0 ? job->col[3][r] : LED_RATING, P = job->res[2][r];
+            textio_printf(o, "%.9g,%.9g,%.9g,%.9g,%s\n", job->out[r], job->res[0][r],
+                          job->res[1][r], P, P != P ? "nan" : P > rating ? "1" : "0");
+        } else
+            textio_printf(o, "%.9g\n", job->out[r]);
+    }
+}
+
+// --sum leaf: NAN (invalid) rows are skipped
+static void batch_sum_leaf(size_t lo, size_t hi, void *ctx, reduce_stats *st)
+{
+    const double *x = ctx;
+    size_t i;
+
+    for (i = lo; i < hi; i++)
+        if (x[i] == x[i]) reduce_add(st, x[i]);
+}
+
+// Runs rows [first, rows); with a journal, ck is the identity of the run
+// and gets the progress of every segment
+static int batch_run_kind(int kind, int series, const textio_table *t, int numa, int sum,
+                          textio_out *o, size_t first, journal_t *jr, journal_ckpt *ck)
+{
+    batch_job job;
+    size_t rows = t->rows, lo, r;
+    int c;
+
+    memset(&job, 0, sizeof(job));
+    job.kind = kind;
+    job.ncols = batch_kinds[kind].cols;
+    job.series = series;
+    job.t = t;
+    job.values = t->values;
+
+    // fixed-width kinds need exactly ncols fields per row
+    for (r = 0; job.ncols && r < t->rows; r++) {
+        if (t->row_start[r + 1] - t->row_start[r] != (size_t)job.ncols) {
+            fprintf(stderr, "batch: data row %zu needs %d columns\n", r + 1, job.ncols);
+            return -1;
+        }
+    }
+
+    job.out = batch_alloc(rows, numa);
+    if (!job.out) return -1;
+    for (c = 0; c < job.ncols; c++)
+        if (!(job.col[c] = batch_alloc(rows, numa))) return -1;
+    for (c = 0; kind == BATCH_LED && c < 3; c++)
+        if (!(job.res[c] = batch_alloc(rows, numa))) return -1;
+    if (numa && !job.ncols) {
+        job.copy = batch_alloc(t->row_start[t->rows], numa);
+        if (!job.copy) return -1;
+        job.values = job.copy;
+    }
+
+    if (first == 0) textio_printf(o, "%s\n", batch_kinds[kind].header);
+    for (lo = first; lo < rows; lo += BATCH_SEGMENT) {
+        size_t hi = (rows - lo > BATCH_SEGMENT) ? lo + BATCH_SEGMENT : rows;
+
+        if (numa) {
+            parallel_for_static(lo, hi, batch_copy_chunk, &job);
+            parallel_for_static(lo, hi, batch_chunk, &job);
+        } else {
+            parallel_for(lo, hi, BATCH_GRAIN, batch_copy_chunk, &job);
+            parallel_for(lo, hi, BATCH_GRAIN, batch_chunk, &job);
+        }
+        batch_write_rows(&job, lo, hi, o);
+
+        // the writer thread syncs and records it while the next segment runs
+        if (jr) {
+            textio_out_flush(o);
+            ck->rows_done = hi;
+            ck->out_bytes = (uint64_t)ftello(o->fp);
+            journal_post(jr, ck);
+        }
+    }
+
+    // total of the result column (P for ohm and led) over the rows that
+    // have a result; failed rows are NAN and only counted
+    if (sum) {
+        reduce_stats st;
+        parallel_reduce(rows, batch_sum_leaf,
+                        kind == BATCH_OHM ? job.col[3] : kind == BATCH_LED ? job.res[2] : job.out, &st);
+        fprintf(stderr, "sum=%.17g\n", st.sum);
+        if (st.n < rows) fprintf(stderr, "batch: %zu invalid row(s) left out of the sum\n", rows - st.n);
+    }
+    return 0;
+}
+
+// Output file for a run: truncated for a new run, cut back to the last
+// checkpoint when resuming
+static FILE *batch_open_output(const char *path, const journal_ckpt *resume)
+{
+    FILE *fp;
+
+    if (!resume) return fopen(path, "w");
+    fp = fopen(path, "r+");
+    if (fp && (ftruncate(fileno(fp), (off_t)resume->out_bytes) != 0 ||
+               fseeko(fp, (off_t)resume->out_bytes, SEEK_SET) != 0)) {
+        fclose(fp);
+        return NULL;
+    }
+    return fp;
+}
+
+int batch_main(int argc, char *argv[])
+{
+    const char *in_path = NULL, *out_path = NULL, *journal_path = NULL;
+    int i, kind = -1, stats = 0, numa = 0, sum = 0, series = 24, status, resume = 0, pin = -1, numa_pin;
+    journal_ckpt ck, last;
+    journal_t jr;
+    struct stat st;
+    textio_table table;
+    textio_out out;
+    size_t len;
+    char *text;
+    FILE *fp = stdout;
+
+    if (argc < 3) { batch_usage(); return 1; }
+
+    for (i = 0; i < BATCH_KIND_COUNT; i++)
+        if (strcmp(argv[1], batch_kinds[i].name) == 0) kind = i;
+    if (kind < 0) { batch_usage(); return 1; }
+
+    for (i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) out_path = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) sched_set_threads(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--pin") == 0 && i + 1 < argc) sched_set_pinning(pin = topo_parse_pin(argv[++i]));
+        else if (strcmp(argv[i], "--numa") == 0) numa = 1;
+        else if (strcmp(argv[i], "--stats") == 0) stats = 1;
+        else if (strcmp(argv[i], "--sum") == 0) sum = 1;
+        else if (strcmp(argv[i], "--deterministic") == 0) reduce_set_deterministic(1);
+        else if (strcmp(argv[i], "--journal") == 0 && i + 1 < argc) journal_path = argv[++i];
+        else if (strcmp(argv[i], "--series") == 0 && i + 1 < argc) {
+            if ((series = eseries_parse(argv[++i])) < 0) { batch_usage(); return 1; }
+        }
+        else if (!in_path) in_path = argv[i];
+        else { batch_usage(); return 1; }
+    }
+    if (!in_path || (journal_path && (!out_path || sum))) { batch_usage(); return 1; }
+
+    text = textio_read_file(&request_arena, in_path, &len);
+    if (!text) {
+        fprintf(stderr, "batch: cannot read '%s'\n", in_path);
+        return 1;
+    }
+    if (textio_parse_csv(&request_arena, text, len, &table) != 0) {
+        if (table.bad_row) fprintf(stderr, "batch: bad number on line %zu\n", table.bad_row);
+        else fprintf(stderr, "batch: out of memory\n");
+        return 1;
+    }
+
+    // a run is the same input file, kind and options; resume it if the
+    // journal has a checkpoint for it
+    if (journal_path) {
+        memset(&ck, 0, sizeof(ck));
+        if (stat(in_path, &st) == 0) {
+            ck.input_size = (uint64_t)st.st_size;
+            ck.input_mtime = (int64_t)st.st_mtime;
+        }
+        ck.kind = (uint32_t)kind;
+        ck.flags = (uint32_t)series;
+        resume = journal_last(journal_path, &last) == 0 && last.input_size == ck.input_size &&
+                 last.input_mtime == ck.input_mtime && last.kind == ck.kind &&
+                 last.flags == ck.flags && last.rows_done <= (uint64_t)table.rows;
+        if (resume) fprintf(stderr, "batch: resuming after row %llu\n", (unsigned long long)last.rows_done);
+    }
+
+    if (out_path && !(fp = batch_open_output(out_path, resume ? &last : NULL))) {
+        fprintf(stderr, "batch: cannot write '%s'\n", out_path);
+        return 1;
+    }
+    if (journal_path && journal_start(&jr, journal_path, fileno(fp), resume) != 0) {
+        fprintf(stderr, "batch: cannot write journal '%s'\n", journal_path);
+        fclose(fp);
+        return 1;
+    }
+
+    // first touch only lands on the reading worker's node if workers stay
+    // put: --numa pins compact unless --pin or TOOLBOX_PIN says otherwise
+    numa_pin = numa && pin < 0 && topo_parse_pin(NULL) == TOPO_PIN_NONE;
+    if (numa_pin) sched_set_pinning(TOPO_PIN_COMPACT);
+
+    textio_out_open(&out, fp);
+    status = batch_run_kind(kind, series, &table, numa, sum, &out,
+                            resume ? (size_t)last.rows_done : 0, journal_path ? &jr : NULL, &ck);
+    textio_out_close(&out);
+    if (numa_pin) sched_set_pinning(-1);
+
+    // the writer syncs through the output descriptor, stop it first; a
+    // finished run needs no journal, a failed one keeps it to resume
+    if (journal_path && journal_stop(&jr) != 0) status = -1;
+    if (journal_path && status == 0) remove(journal_path);
+    if (fp != stdout) fclose(fp);
+
+    if (stats) {
+        arena_print_stats(&request_arena, "request");
+        arena_print_stats(&session_arena, "session");
+    }
+    batch_unmap();
+    arena_reset(&request_arena);
+    return status == 0 ? 0 : 1;
+}
@@ -0,0 +1,12 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+// Batch (CSV) mode
+// "main.out batch <kind> <in.csv> [-o out.csv] [--threads N] [--numa]
+//  [--pin none|compact|spread] [--stats] [--series E24] [--journal run.jnl]"
+// runs one kernel over every row of a CSV file and writes one result row
+// per input row.
+
+int batch_main(int argc, char *argv[]);
+
+#endif
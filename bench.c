@@ -0,0 +1,927 @@
+// Performance benchmarks
+// Build and run with "make bench". Each benchmark is one row in the table
+// at the bottom; "bench.out <name>" runs just that one.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include "funcs.h"
+#include "arena.h"
+#include "scheduler.h"
+#include "topology.h"
+#include "fixed.h"
+#include "interval.h"
+#include "bandscan.h"
+#include "smd.h"
+#include "inventory.h"
+#include "divider.h"
+#include "rcselect.h"
+#include "montecarlo.h"
+#include "energy.h"
+#include "logrec.h"
+#include "logexport.h"
+#include "calclog.h"
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// ---- Scheduler scaling ----
+
+#define SCALE_ROWS  (8 * 1024 * 1024)
+#define SCALE_GRAIN 16384
+#define SCALE_REPS  3
+
+typedef struct {
+    const double *R, *C, *V, *t;
+    double       *out;
+} rc_job;
+
+static void rc_chunk(size_t lo, size_t hi, void *arg)
+{
+    const rc_job *j = arg;
+    rc_charge_batch(j->R + lo, j->C + lo, j->V + lo, j->t + lo, j->out + lo, (int)(hi - lo));
+}
+
+// RC charge over 8M rows with 1..N worker threads
+static void bench_scaling(void)
+{
+    arena_t a = ARENA_INIT(1 << 20);
+    double *R = arena_alloc(&a, sizeof(double) * SCALE_ROWS);
+    double *C = arena_alloc(&a, sizeof(double) * SCALE_ROWS);
+    double *V = arena_alloc(&a, sizeof(double) * SCALE_ROWS);
+    double *t = arena_alloc(&a, sizeof(double) * SCALE_ROWS);
+    double *out = arena_alloc(&a, sizeof(double) * SCALE_ROWS);
+    double base = 0.0;
+    int i, threads, max_threads = sched_threads();
+    rc_job job;
+
+    if (!R || !C || !V || !t || !out) {
+        printf("scaling: out of memory\n");
+        return;
+    }
+    for (i = 0; i < SCALE_ROWS; i++) {
+        R[i] = 1e3 + i % 1000;
+        C[i] = 1e-6;
+        V[i] = 5.0;
+        t[i] = 1e-4 * (i % 100);
+    }
+    job.R = R; job.C = C; job.V = V; job.t = t; job.out = out;
+
+    printf("\n== Scheduler scaling: rc_charge_batch, %d rows ==\n", SCALE_ROWS);
+    printf("threads\t   ms\t Mrows/s\tspeedup\n");
+    for (threads = 1; threads <= max_threads; threads *= 2) {
+        double best = 1e30;
+        int rep;
+
+        sched_set_threads(threads);
+        for (rep = 0; rep < SCALE_REPS; rep++) {
+            double t0 = now_sec();
+            parallel_for(0, SCALE_ROWS, SCALE_GRAIN, rc_chunk, &job);
+            t0 = now_sec() - t0;
+            if (t0 < best) best = t0;
+        }
+        if (threads == 1) base = best;
+        printf("%7d\t%7.2f\t%8.1f\t%6.2fx\n", threads, best * 1e3,
+               SCALE_ROWS / best / 1e6, base / best);
+
+        // also measure the exact core count when it is not a power of two
+        if (threads < max_threads && threads * 2 > max_threads) threads = max_threads / 2;
+    }
+
+    sched_shutdown();
+    sched_set_threads(0);
+    arena_free(&a);
+}
+
+// ---- NUMA placement ----
+
+#define NUMA_ELEMS   (16 * 1024 * 1024)
+#define NUMA_REPS    3
+#define MAX_WORKERS  256
+
+typedef struct {
+    const double *a;
+    double       *b;
+    double        seconds[MAX_WORKERS];
+    size_t        bytes[MAX_WORKERS];
+    int           node[MAX_WORKERS];
+} stream_job;
+
+// b = 2.5 a + 1, timed per worker
+static void stream_chunk(size_t lo, size_t hi, void *arg)
+{
+    stream_job *j = arg;
+    int w = sched_worker_id() < 0 ? 0 : sched_worker_id();
+    double t0 = now_sec();
+    size_t i;
+
+    for (i = lo; i < hi; i++) j->b[i] = 2.5 * j->a[i] + 1.0;
+
+    j->seconds[w] = now_sec() - t0;
+    j->bytes[w] = (hi - lo) * 2 * sizeof(double);
+    j->node[w] = topo_current_node();
+}
+
+static void fill_chunk(size_t lo, size_t hi, void *arg)
+{
+    stream_job *j = arg;
+    size_t i;
+    for (i = lo; i < hi; i++) ((double *)j->a)[i] = (double)i;
+}
+
+// Runs the stream kernel and prints GB/s per node
+static void numa_report(const char *label, stream_job *job)
+{
+    double node_bytes[TOPO_MAX_NODES] = { 0 }, node_time[TOPO_MAX_NODES] = { 0 };
+    double best = 1e30;
+    int rep, w, node, nodes = topo_nodes();
+
+    for (rep = 0; rep < NUMA_REPS; rep++) {
+        double t0 = now_sec(), total;
+        memset(job->seconds, 0, sizeof(job->seconds));
+        parallel_for_static(0, NUMA_ELEMS, stream_chunk, job);
+        total = now_sec() - t0;
+        if (total >= best) continue;
+
+        best = total;
+        memset(node_bytes, 0, sizeof(node_bytes));
+        memset(node_time, 0, sizeof(node_time));
+        for (w = 0; w < MAX_WORKERS; w++) {
+            if (job->seconds[w] <= 0.0) continue;
+            node = job->node[w];
+            node_bytes[node] += job->bytes[w];
+            if (job->seconds[w] > node_time[node]) node_time[node] = job->seconds[w];
+        }
+    }
+
+    printf("%-12s total %6.2f GB/s", label, NUMA_ELEMS * 2.0 * sizeof(double) / best / 1e9);
+    for (node = 0; node < nodes; node++)
+        if (node_time[node] > 0.0)
+            printf("  node%d %6.2f GB/s", node, node_bytes[node] / node_time[node] / 1e9);
+    printf("\n");
+}
+
+// Stream kernel over 2 x 128 MB with pages placed by the main thread
+// versus first touch by the worker that processes them
+static void bench_numa(void)
+{
+    size_t bytes = sizeof(double) * NUMA_ELEMS;
+    static stream_job job;
+    double *a, *b;
+
+    sched_set_threads(topo_cpus());
+    sched_set_pinning(TOPO_PIN_SPREAD);
+
+    printf("\n== NUMA placement: %d node(s), %d CPU(s), %d threads pinned spread ==\n",
+           topo_nodes(), topo_cpus(), sched_threads());
+
+    // every page first touched by the main thread
+    a = topo_alloc(bytes);
+    b = topo_alloc(bytes);
+    if (!a || !b) {
+        printf("numa: out of memory\n");
+        return;
+    }
+    job.a = a;
+    job.b = b;
+    memset(b, 0, bytes);
+    fill_chunk(0, NUMA_ELEMS, &job);
+    numa_report("main-thread", &job);
+    topo_free(a, bytes);
+    topo_free(b, bytes);
+
+    // pages first touched by their worker
+    a = topo_alloc(bytes);
+    b = topo_alloc(bytes);
+    if (!a || !b) {
+        printf("numa: out of memory\n");
+        return;
+    }
+    job.a = a;
+    job.b = b;
+    topo_first_touch(b, sizeof(double), NUMA_ELEMS);
+    parallel_for_static(0, NUMA_ELEMS, fill_chunk, &job);
+    numa_report("first-touch", &job);
+    topo_free(a, bytes);
+    topo_free(b, bytes);
+
+    sched_shutdown();
+    sched_set_pinning(-1);
+    sched_set_threads(0);
+}
+
+// ---- Small networks ----
+
+#define SMALL_CALLS (4 * 1024 * 1024)
+#define SMALL_SETS  64
+
+typedef float (*sp_func_t)(const float r[], int count);
+
+// ns per call over SMALL_SETS different inputs of n resistors
+static double small_ns(sp_func_t f, const float *sets, int n)
+{
+    volatile float sink = 0.0f;
+    double best = 1e30;
+    int rep, i;
+
+    for (rep = 0; rep < 3; rep++) {
+        double t0 = now_sec();
+        for (i = 0; i < SMALL_CALLS; i++)
+            sink += f(sets + (i % SMALL_SETS) * 16, n);
+        t0 = now_sec() - t0;
+        if (t0 < best) best = t0;
+    }
+    (void)sink;
+    return best / SMALL_CALLS * 1e9;
+}
+
+// Unrolled calc_series/calc_parallel against the generic loops, n = 1..16
+static void bench_small(void)
+{
+    static float sets[SMALL_SETS * 16];
+    int i, n;
+
+    for (i = 0; i < SMALL_SETS * 16; i++) sets[i] = 100.0f + (float)(i * 37 % 9900);
+
+    printf("\n== Small networks: ns per call, %d calls ==\n", SMALL_CALLS);
+    printf("  n\tseries\t  loop\tparallel\t  loop\n");
+    for (n = 1; n <= 16; n++)
+        printf("%3d\t%6.2f\t%6.2f\t%8.2f\t%6.2f\n", n,
+               small_ns(calc_series, sets, n), small_ns(calc_series_loop, sets, n),
+               small_ns(calc_parallel, sets, n), small_ns(calc_parallel_loop, sets, n));
+}
+
+// ---- Fixed point ----
+
+#define FX_CASES 200000
+#define FX_PI    3.14159265358979323846
+
+static unsigned fx_seed = 12345;
+
+// Uniform in [lo, hi) from a small LCG so runs are repeatable
+static double fx_rand(double lo, double hi)
+{
+    fx_seed = fx_seed * 1103515245u + 12345u;
+    return lo + (hi - lo) * ((fx_seed >> 8) / 16777216.0);
+}
+
+typedef struct {
+    const char *name;
+    double      max_abs, max_rel;
+    double      fx_sec, dbl_sec;
+} fx_result;
+
+static void fx_track(fx_result *r, double got, double want)
+{
+    double err = fabs(got - want);
+    if (err > r->max_abs) r->max_abs = err;
+    // relative error only where the value is well above 1 LSB
+    if (fabs(want) > 0.01 && err / fabs(want) > r->max_rel) r->max_rel = err / fabs(want);
+}
+
+static void fx_print(const fx_result *r)
+{
+    printf("%-12s %10.3g %10.3g %9.2f %9.2f\n", r->name, r->max_abs, r->max_rel,
+           r->fx_sec / FX_CASES * 1e9, r->dbl_sec / FX_CASES * 1e9);
+}
+
+// Q16 kernels against the double formulas: worst error and ns per call
+static void bench_fixed(void)
+{
+    static double R[FX_CASES][4], V[FX_CASES], t[FX_CASES], C[FX_CASES], want[FX_CASES];
+    static fx_t qR[FX_CASES][4], qV[FX_CASES], qt[FX_CASES], qC[FX_CASES], got[FX_CASES];
+    fx_result res[4] = { { .name = "series" }, { .name = "parallel" },
+                         { .name = "rc_charge" }, { .name = "dds_sine" } };
+    volatile double dsink = 0.0;
+    volatile fx_t qsink = 0;
+    double t0;
+    fx_dds dds;
+    int i, j, k;
+
+    // the double path gets the Q16-rounded inputs back, so the table
+    // shows the error of the kernels rather than of the input rounding
+    for (i = 0; i < FX_CASES; i++) {
+        for (j = 0; j < 4; j++) {
+            qR[i][j] = FX_FROM_DOUBLE(pow(10.0, fx_rand(1.0, 6.0)));
+            R[i][j] = FX_TO_DOUBLE(qR[i][j]);
+        }
+        qC[i] = FX_FROM_DOUBLE(pow(10.0, fx_rand(0.0, 4.0)));           // nF
+        qV[i] = FX_FROM_DOUBLE(fx_rand(1.0, 24.0));
+        qt[i] = FX_FROM_DOUBLE(fx_rand(0.0, 5.0) * R[i][0] * FX_TO_DOUBLE(qC[i]) * 1e-3); // µs
+        C[i] = FX_TO_DOUBLE(qC[i]) * 1e-9;
+        V[i] = FX_TO_DOUBLE(qV[i]);
+        t[i] = FX_TO_DOUBLE(qt[i]) * 1e-6;
+    }
+
+    for (k = 0; k < 4; k++) {
+        t0 = now_sec();
+        for (i = 0; i < FX_CASES; i++) {
+            switch (k) {
+            case 0: got[i] = fx_series(qR[i], 4); break;
+            case 1: got[i] = fx_parallel(qR[i], 4); break;
+            case 2: got[i] = fx_rc_charge(qR[i][0], qC[i], qV[i], qt[i]); break;
+            case 3:
+                if (i == 0) fx_dds_init(&dds, FX_ONE, FX_FROM_INT(50), FX_FROM_INT(48000), 0);
+                got[i] = fx_dds_next(&dds);
+                break;
+            }
+            qsink += got[i];
+        }
+        res[k].fx_sec = now_sec() - t0;
+
+        t0 = now_sec();
+        for (i = 0; i < FX_CASES; i++) {
+            switch (k) {
+            case 0: want[i] = R[i][0] + R[i][1] + R[i][2] + R[i][3]; break;
+            case 1: want[i] = 1.0 / (1.0 / R[i][0] + 1.0 / R[i][1] + 1.0 / R[i][2] + 1.0 / R[i][3]); break;
+            case 2: want[i] = V[i] * (1.0 - exp(-t[i] / (R[i][0] * C[i]))); break;
+            case 3: want[i] = sin(2 * FX_PI * 50.0 * i / 48000.0); break;
+            }
+            dsink += want[i];
+        }
+        res[k].dbl_sec = now_sec() - t0;
+
+        for (i = 0; i < FX_CASES; i++) fx_track(&res[k], FX_TO_DOUBLE(got[i]), want[i]);
+    }
+    (void)dsink;
+    (void)qsink;
+
+    printf("\n== Fixed point (Q%d) vs double, %d cases ==\n", FX_FRAC, FX_CASES);
+    printf("%-12s %10s %10s %9s %9s\n", "kernel", "max abs", "max rel", "fx ns", "double ns");
+    for (k = 0; k < 4; k++) fx_print(&res[k]);
+    printf("(1 LSB = %.3g)\n", 1.0 / FX_ONE);
+}
+
+// ---- Interval arithmetic ----
+
+#define IVAL_ROWS (1024 * 1024)
+
+// Interval RC charge (both bounds) against the nominal batch kernel
+static void bench_interval(void)
+{
+    arena_t a = ARENA_INIT(1 << 20);
+    double *R = arena_alloc(&a, sizeof(double) * IVAL_ROWS * 5), *C = R + IVAL_ROWS;
+    double *V = C + IVAL_ROWS, *t = V + IVAL_ROWS, *out = t + IVAL_ROWS;
+    ival *iR = arena_alloc(&a, sizeof(ival) * IVAL_ROWS * 5), *iC = iR + IVAL_ROWS;
+    ival *iV = iC + IVAL_ROWS, *it = iV + IVAL_ROWS, *iout = it + IVAL_ROWS;
+    double t_nom = 1e30, t_ival = 1e30, t0, width = 0.0;
+    int i, rep, outside = 0;
+
+    if (!R || !iR) {
+        printf("interval: out of memory\n");
+        return;
+    }
+    for (i = 0; i < IVAL_ROWS; i++) {
+        R[i] = 1e3 + i % 1000;
+        C[i] = 1e-6;
+        V[i] = 5.0;
+        t[i] = 1e-4 * (i % 100);
+        iR[i] = ival_tol(R[i], 5.0);
+        iC[i] = ival_tol(C[i], 10.0);
+        iV[i] = ival_tol(V[i], 0.0);
+        it[i] = ival_tol(t[i], 0.0);
+    }
+
+    for (rep = 0; rep < 3; rep++) {
+        t0 = now_sec();
+        rc_charge_batch(R, C, V, t, out, IVAL_ROWS);
+        t0 = now_sec() - t0;
+        if (t0 < t_nom) t_nom = t0;
+
+        t0 = now_sec();
+        ival_rc_charge_batch(iR, iC, iV, it, iout, IVAL_ROWS);
+        t0 = now_sec() - t0;
+        if (t0 < t_ival) t_ival = t0;
+    }
+    for (i = 0; i < IVAL_ROWS; i++) {
+        if (out[i] < iout[i].lo || out[i] > iout[i].hi) outside++;
+        width += iout[i].hi - iout[i].lo;
+    }
+
+    printf("\n== Interval RC charge, %d rows (R 5%%, C 10%%) ==\n", IVAL_ROWS);
+    printf("nominal   %8.2f ms\n", t_nom * 1e3);
+    printf("interval  %8.2f ms  (%.2fx)\n", t_ival * 1e3, t_ival / t_nom);
+    printf("mean width %.4g V, nominal outside bounds: %d\n", width / IVAL_ROWS, outside);
+    arena_free(&a);
+}
+
+// ---- Band recognition ----
+
+#define SCAN_W      1280
+#define SCAN_H      720
+#define SCAN_FRAMES 200
+
+// Frames per second of scan_bands() on a synthetic 720p resistor image
+static void bench_scan(void)
+{
+    static const unsigned char body[3] = { 215, 190, 145 }, bg[3] = { 60, 70, 60 };
+    static const unsigned char band_rgb[4][3] = {
+        { 255, 215, 0 }, { 140, 60, 170 }, { 200, 30, 30 }, { 200, 165, 70 }
+    };
+    static const int band_x[4] = { 420, 500, 580, 800 };
+    arena_t a = ARENA_INIT(1 << 20);
+    image_t img;
+    int bands[6], n = 0, x, y, k, f;
+    unsigned seed = 1;
+    double t0;
+
+    img.w = SCAN_W;
+    img.h = SCAN_H;
+    img.rgb = arena_alloc(&a, (size_t)SCAN_W * SCAN_H * 3);
+    if (!img.rgb) {
+        printf("scan: out of memory\n");
+        return;
+    }
+    for (y = 0; y < SCAN_H; y++)
+        for (x = 0; x < SCAN_W; x++) {
+            const unsigned char *c = bg;
+            unsigned char *p = img.rgb + ((size_t)y * SCAN_W + x) * 3;
+
+            if (y > 300 && y < 420 && x > 340 && x < 940) {
+                c = body;
+                for (k = 0; k < 4; k++)
+                    if (x >= band_x[k] && x < band_x[k] + 36) c = band_rgb[k];
+            }
+            for (k = 0; k < 3; k++) {
+                seed = seed * 1103515245u + 12345u;
+                p[k] = (unsigned char)(c[k] * 15 / 16 + (seed >> 24) % 16);
+            }
+        }
+
+    t0 = now_sec();
+    for (f = 0; f < SCAN_FRAMES; f++) n = scan_bands(&img, bands, 6);
+    t0 = now_sec() - t0;
+
+    printf("\n== Band recognition, %dx%d frames ==\n", SCAN_W, SCAN_H);
+    printf("%.3f ms/frame, %.0f frames/s, bands:", t0 / SCAN_FRAMES * 1e3, SCAN_FRAMES / t0);
+    for (k = 0; k < n; k++) printf(" %s", color_name(bands[k]));
+    printf("\n");
+    arena_free(&a);
+}
+
+#define SMD_CODES (1024 * 1024)
+
+// Millions of SMD markings per second encoded and decoded, on values
+// spread log-uniformly over 1 Ω .. 1 MΩ; every code must decode and
+// encode back to itself
+static void bench_smd(void)
+{
+    static const char *const style_names[3] = { "3-digit", "4-digit", "EIA-96" };
+    arena_t a = ARENA_INIT(1 << 20);
+    double *R = arena_alloc(&a, sizeof(double) * SMD_CODES);
+    double *back = arena_alloc(&a, sizeof(double) * SMD_CODES);
+    char (*code)[SMD_CODE_MAX] = arena_alloc(&a, SMD_CODE_MAX * (size_t)SMD_CODES);
+    const char **text = arena_alloc(&a, sizeof(char *) * SMD_CODES);
+    unsigned seed = 1;
+    int i, style;
+
+    if (!R || !back || !code || !text) {
+        printf("smd: out of memory\n");
+        arena_free(&a);
+        return;
+    }
+    for (i = 0; i < SMD_CODES; i++) {
+        seed = seed * 1103515245u + 12345u;
+        R[i] = pow(10.0, 6.0 * (seed >> 8) / (1 << 24));
+        text[i] = code[i];
+    }
+
+    printf("\n== SMD markings, %d values ==\n", SMD_CODES);
+    printf("%-8s %12s %12s %8s\n", "style", "encode M/s", "decode M/s", "errors");
+    for (style = SMD_3DIGIT; style <= SMD_EIA96; style++) {
+        double te, td;
+        char again[SMD_CODE_MAX];
+        int bad;
+
+        te = now_sec();
+        bad = smd_encode_batch(R, SMD_CODES, style, code);
+        te = now_sec() - te;
+        td = now_sec();
+        bad += smd_decode_batch(text, SMD_CODES, back);
+        td = now_sec() - td;
+        for (i = 0; i < SMD_CODES; i++)
+            bad += (smd_encode(back[i], style, again) != 0 || strcmp(again, code[i]) != 0);
+
+        printf("%-8s %12.1f %12.1f %8d\n", style_names[style],
+               SMD_CODES / te / 1e6, SMD_CODES / td / 1e6, bad);
+    }
+    arena_free(&a);
+}
+
+#define INV_PARTS   300000
+#define INV_LOOKUPS (1024 * 1024)
+#define INV_PATH    "bench_inventory.db"
+
+// Open time and lookup latency of an inventory of INV_PARTS SKUs spread
+// over 1 Ω .. 10 MΩ, a quarter of them out of stock
+static void bench_inventory(void)
+{
+    arena_t a = ARENA_INIT(1 << 20);
+    inv_part *parts = arena_alloc(&a, sizeof(inv_part) * INV_PARTS);
+    inventory db;
+    unsigned seed = 1;
+    double t_open, t_find, sum = 0;
+    int i, found = 0;
+
+    if (!parts) {
+        printf("inventory: out of memory\n");
+        arena_free(&a);
+        return;
+    }
+    for (i = 0; i < INV_PARTS; i++) {
+        seed = seed * 1103515245u + 12345u;
+        parts[i].value = pow(10.0, 7.0 * (seed >> 8) / (1 << 24));
+        parts[i].tol = (seed & 1) ? 100 : 500;
+        parts[i].package = (seed & 2) ? 603 : 805;
+        parts[i].qty = (seed >> 2) % 4 ? 100 : 0;
+    }
+    if (inv_build(INV_PATH, parts, INV_PARTS) != 0) {
+        printf("inventory: cannot write %s\n", INV_PATH);
+        arena_free(&a);
+        return;
+    }
+
+    t_open = now_sec();
+    if (inv_open(&db, INV_PATH) != 0) {
+        printf("inventory: cannot open %s\n", INV_PATH);
+        arena_free(&a);
+        return;
+    }
+    t_open = now_sec() - t_open;
+
+    t_find = now_sec();
+    for (i = 0; i < INV_LOOKUPS; i++) {
+        int k;
+        seed = seed * 1103515245u + 12345u;
+        k = inv_find(&db, pow(10.0, 7.0 * (seed >> 8) / (1 << 24)), 0.01, 603, 1);
+        if (k >= 0) { found++; sum += db.value[k]; }
+    }
+    t_find = now_sec() - t_find;
+
+    printf("\n== Inventory, %d parts ==\n", INV_PARTS);
+    printf("open %.3f ms, %.3f us/lookup, %d of %d found (checksum %.6g)\n",
+           t_open * 1e3, t_find / INV_LOOKUPS * 1e6, found, INV_LOOKUPS, sum);
+    inv_close(&db);
+    remove(INV_PATH);
+    arena_free(&a);
+}
+
+#define DIV_RATIOS 16
+
+// Time per divider design: single parts in E24 and E192, and two-part
+// legs in E24 and E96, for DIV_RATIOS ratios across 0.05 .. 0.95
+static void bench_divider(void)
+{
+    static const int series[4] = { 24, 192, 24, 96 }, legs[4] = { 1, 1, 2, 2 };
+    div_result best[10];
+    div_spec s = { 0 };
+    int c, i;
+
+    printf("\n== Divider designer, %d ratios, 10 results each ==\n", DIV_RATIOS);
+    printf("%-6s %5s %12s %16s\n", "series", "legs", "ms/design", "worst best ppm");
+    s.vin = 1;
+    for (c = 0; c < 4; c++) {
+        double t0, worst = 0;
+
+        s.series = series[c];
+        s.legs = legs[c];
+        t0 = now_sec();
+        for (i = 0; i < DIV_RATIOS; i++) {
+            s.ratio = 0.05 + 0.9 * i / (DIV_RATIOS - 1);
+            if (divider_design(&s, best, 10) > 0 && fabs(best[0].err) > worst) worst = fabs(best[0].err);
+        }
+        t0 = now_sec() - t0;
+        printf("E%-5d %5d %12.3f %16.1f\n", s.series, s.legs, t0 / DIV_RATIOS * 1e3, worst * 1e6);
+    }
+    arena_reset(&request_arena);
+}
+
+#define RC_TARGETS 64
+#define RC_MC_N    100000
+
+// Time per RC selection (E192 resistors x E24 capacitors over 1 Ω .. 10 MΩ
+// and 1 pF .. 1 mF) and per Monte Carlo spread of one pick
+static void bench_rcselect(void)
+{
+    rc_spec s = { 0 };
+    rc_pick best[5];
+    reduce_stats st;
+    mc_rc mc;
+    double t_sel, t_mc;
+    int i, found = 0;
+
+    s.tol = 0.01;
+    s.rseries = 192;
+    s.cseries = 24;
+    s.rmin = 1;
+    s.rmax = 10e6;
+    s.cmin = 1e-12;
+    s.cmax = 1e-3;
+
+    t_sel = now_sec();
+    for (i = 0; i < RC_TARGETS; i++) {
+        s.tau = pow(10.0, -6.0 + 6.0 * i / RC_TARGETS);
+        found += rc_select(&s, best, 5) > 0;
+    }
+    t_sel = now_sec() - t_sel;
+
+    mc = (mc_rc){ best[0].R, best[0].C, 0.01, 0.10, 0, 1 };
+    reduce_init(&st);
+    t_mc = now_sec();
+    mc_rc_run(&mc, RC_MC_N, &st);
+    t_mc = now_sec() - t_mc;
+
+    printf("\n== RC selector, E192 x E24 ==\n");
+    printf("%.3f ms/selection (%d of %d targets met), %.2f ms per %d-sample spread\n",
+           t_sel / RC_TARGETS * 1e3, found, RC_TARGETS, t_mc * 1e3, RC_MC_N);
+    arena_reset(&request_arena);
+}
+
+#define ENERGY_SAMPLES (8 * 1024 * 1024)
+#define ENERGY_CHUNK   16384
+
+// Samples per second of power_batch + trapezoid integration on a t,V,I
+// profile fed in reader-sized blocks (the parse cost is not included)
+static void bench_energy(void)
+{
+    arena_t a = ARENA_INIT(1 << 20);
+    double *t = arena_alloc(&a, sizeof(double) * ENERGY_SAMPLES);
+    double *V = arena_alloc(&a, sizeof(double) * ENERGY_SAMPLES);
+    double *I = arena_alloc(&a, sizeof(double) * ENERGY_SAMPLES);
+    double *P = arena_alloc(&a, sizeof(double) * ENERGY_SAMPLES);
+    energy_acc acc;
+    double t0;
+    int i;
+
+    if (!t || !V || !I || !P) {
+        printf("energy: out of memory\n");
+        arena_free(&a);
+        return;
+    }
+    for (i = 0; i < ENERGY_SAMPLES; i++) {
+        t[i] = i * 1e-4;
+        V[i] = 3.7 - 1e-8 * i;
+        I[i] = (i % 1000 < 50) ? 0.250 : 0.002;
+    }
+
+    energy_init(&acc);
+    t0 = now_sec();
+    for (i = 0; i < ENERGY_SAMPLES; i += ENERGY_CHUNK) {
+        power_batch(V + i, I + i, P + i, ENERGY_CHUNK);
+        energy_add(&acc, t + i, P + i, ENERGY_CHUNK);
+    }
+    t0 = now_sec() - t0;
+
+    printf("\n== Energy integration, %d samples ==\n", ENERGY_SAMPLES);
+    printf("%.1f M samples/s, %.6g J, avg %.6g W\n",
+           ENERGY_SAMPLES / t0 / 1e6, acc.energy, energy_avg_power(&acc));
+    arena_free(&a);
+}
+
+// Typed log records against the text summaries they replaced: reading a
+// field back is a decode instead of an sscanf of the line
+#define LOGREC_RECORDS (1024 * 1024)
+
+static void bench_logrec(void)
+{
+    unsigned char data[LOGREC_MAX_SIZE];
+    char line[LOGREC_TEXT_MAX];
+    double t_dec, t_fmt, t_scan, sum = 0, V, I, R, P;
+    size_t len, chars = 0;
+    logrec rec, back;
+    int i;
+
+    logrec_init(&rec, LR_OHM);
+    rec.f[0] = 5; rec.f[1] = 0.05; rec.f[2] = 100; rec.f[3] = 0.25;
+    len = logrec_encode(&rec, data);
+
+    t_dec = now_sec();
+    for (i = 0; i < LOGREC_RECORDS; i++) {
+        data[LOGREC_HEADER] ^= (unsigned char)(i & 1);   // keep the loop honest
+        if (logrec_decode(data, len, &back) == 0) sum += back.f[2];
+    }
+    t_dec = now_sec() - t_dec;
+
+    t_fmt = now_sec();
+    for (i = 0; i < LOGREC_RECORDS; i++) {
+        rec.time_us += 1000;
+        len = logrec_encode(&rec, data);
+        chars += logrec_format(data, len, line, sizeof(line));
+    }
+    t_fmt = now_sec() - t_fmt;
+
+    snprintf(line, sizeof(line), "Ohm/Power: V=%.6g, I=%.6g, R=%.6g, P=%.6g", 5.0, 0.05, 100.0, 0.25);
+    t_scan = now_sec();
+    for (i = 0; i < LOGREC_RECORDS; i++)
+        if (sscanf(line, "Ohm/Power: V=%lf, I=%lf, R=%lf, P=%lf", &V, &I, &R, &P) == 4) sum += R;
+    t_scan = now_sec() - t_scan;
+
+    printf("\n== Log records, %d per pass ==\n", LOGREC_RECORDS);
+    printf("decode %.1f M/s, format %.1f M/s (%.1f MB/s), text sscanf %.1f M/s (%g)\n",
+           LOGREC_RECORDS / t_dec / 1e6, LOGREC_RECORDS / t_fmt / 1e6,
+           chars / t_fmt / 1e6, LOGREC_RECORDS / t_scan / 1e6, sum);
+}
+
+// Export of a log of LOGX_RECORDS typed records with calculator-like
+// values (3 significant digits) to each format
+#define LOGX_RECORDS (2 * 1024 * 1024)
+#define LOGX_PATH    "bench_calc_log.bin"
+#define LOGX_OUT     "bench_calc_log.out"
+
+static void bench_logexport(void)
+{
+    static const char *const names[] = { "csv", "jsonl", "col" };
+    unsigned char frame[CLOG_HEADER + LOGREC_MAX_SIZE];
+    uint32_t head[3];
+    unsigned seed = 1;
+    logx_stats st;
+    logrec rec;
+    size_t len, bytes = 0;
+    FILE *fp = fopen(LOGX_PATH, "wb");
+    double t0;
+    int i, k;
+
+    if (!fp) {
+        printf("logexport: cannot write %s\n", LOGX_PATH);
+        return;
+    }
+    for (i = 0; i < LOGX_RECORDS; i++) {
+        logrec_init(&rec, (logrec_module)(1 + i % (LR_MODULE_COUNT - 1)));
+        for (k = 0; k < rec.nfields; k++) {
+            seed = seed * 1103515245u + 12345u;
+            rec.f[k] = (100 + (seed >> 8) % 900) * pow(10.0, (int)(seed % 13) - 8);
+        }
+        len = logrec_encode(&rec, frame + CLOG_HEADER);
+        head[0] = CLOG_MAGIC;
+        head[1] = (uint32_t)len;
+        head[2] = clog_crc32(frame + CLOG_HEADER, len);
+        memcpy(frame, head, CLOG_HEADER);
+        bytes += fwrite(frame, 1, CLOG_HEADER + len, fp);
+    }
+    fclose(fp);
+
+    printf("\n== Log export, %d records (%.1f MB), %d threads ==\n",
+           LOGX_RECORDS, bytes / 1e6, sched_threads());
+    for (k = LOGX_CSV; k <= LOGX_COL; k++) {
+        t0 = now_sec();
+        if (logx_export(LOGX_PATH, LOGX_OUT, k, 0, &st) != 0) {
+            printf("%-6s failed\n", names[k]);
+            continue;
+        }
+        t0 = now_sec() - t0;
+        printf("%-6s %.3f s, %.1f M records/s, %.0f MB/s of log\n",
+               names[k], t0, st.rows / t0 / 1e6, bytes / t0 / 1e6);
+    }
+    remove(LOGX_OUT);
+    remove(LOGX_PATH);
+}
+
+// Cold start: each subcommand run as a new process, as a script would,
+// timed from spawn to the first byte of its output and to its exit.
+// Needs main.out ("make bench" builds it); static.out is timed too when
+// it has been built with "make static".
+#define COLD_RUNS 40
+
+extern char **environ;
+
+static const char *const cold_cmds[][8] = {
+    { "ohm", "--V", "5", "--R", "1k" },
+    { "decode", "red", "red", "brown", "gold" },
+    { "encode", "4k7" },
+    { "series", "1k", "2k2", "330" },
+    { "rc", "--R", "10k", "--C", "1u", "--t", "5m" },
+    { "period", "--f", "50" },
+    { "sine", "--f", "50", "--fs", "1k", "--N", "20" },
+    { "mc", "series", "--N", "1k", "1k", "2k2" },
+    { "marking", "capacitor", "104" },
+    { "smd", "decode", "472" },
+    { "divider", "--ratio", "0.25" },
+    { "rcselect", "--tau", "1m" },
+    { "bounds", "series", "4k7@5", "1k@1" },
+    { "repl", "par(10k, 4k7)" },
+    { "log", "check", "--file", "bench_no_such_log.bin" },
+};
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Runs bin with args once, returns 0 and the two times on success
+static int cold_run(const char *bin, const char *const *args, double *first, double *done)
+{
+    char *argv[10], buf[4096];
+    posix_spawn_file_actions_t fa;
+    int fds[2], status, i, rc;
+    double t0;
+    ssize_t n;
+    pid_t pid;
+
+    argv[0] = (char *)bin;
+    for (i = 0; i < 8 && args[i]; i++) argv[i + 1] = (char *)args[i];
+    argv[i + 1] = NULL;
+    if (pipe(fds) != 0) return -1;
+
+    posix_spawn_file_actions_init(&fa);
+    posix_spawn_file_actions_adddup2(&fa, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&fa, fds[0]);
+    posix_spawn_file_actions_addclose(&fa, fds[1]);
+    posix_spawn_file_actions_addopen(&fa, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+    t0 = now_sec();
+    rc = posix_spawn(&pid, bin, &fa, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&fa);
+    close(fds[1]);
+    if (rc != 0) {
+        close(fds[0]);
+        return -1;
+    }
+    n = read(fds[0], buf, sizeof(buf));
+    *first = now_sec() - t0;
+    while (n > 0) n = read(fds[0], buf, sizeof(buf));
+    close(fds[0]);
+    waitpid(pid, &status, 0);
+    *done = now_sec() - t0;
+    return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : -1;
+}
+
+static void bench_coldstart(void)
+{
+    static const char *const bins[] = { "./main.out", "./static.out" };
+    double first[COLD_RUNS], done[COLD_RUNS];
+    int b, c, r;
+
+    for (b = 0; b < 2; b++) {
+        if (access(bins[b], X_OK) != 0) {
+            if (b == 0) printf("\ncoldstart: %s not found, run \"make main.out\"\n", bins[b]);
+            continue;
+        }
+        printf("\n== Cold start, %s, median of %d runs ==\n", bins[b], COLD_RUNS);
+        printf("%-10s %12s %12s\n", "command", "first_out_us", "exit_us");
+        for (c = 0; c < (int)(sizeof(cold_cmds) / sizeof(cold_cmds[0])); c++) {
+            for (r = 0; r < COLD_RUNS; r++)
+                if (cold_run(bins[b], cold_cmds[c], &first[r], &done[r]) != 0) break;
+            if (r < COLD_RUNS) {
+                printf("%-10s failed\n", cold_cmds[c][0]);
+                continue;
+            }
+            qsort(first, COLD_RUNS, sizeof(double), cmp_double);
+            qsort(done, COLD_RUNS, sizeof(double), cmp_double);
+            printf("%-10s %12.0f %12.0f\n", cold_cmds[c][0],
+                   first[COLD_RUNS / 2] * 1e6, done[COLD_RUNS / 2] * 1e6);
+        }
+    }
+}
+
+typedef struct {
+    const char *name;
+    void      (*run)(void);
+} bench_entry;
+
+static const bench_entry benches[] = {
+    { "scaling", bench_scaling },
+    { "numa",    bench_numa },
+    { "small",   bench_small },
+    { "fixed",   bench_fixed },
+    { "interval", bench_interval },
+    { "scan",    bench_scan },
+    { "smd",     bench_smd },
+    { "inventory", bench_inventory },
+    { "divider", bench_divider },
+    { "rcselect", bench_rcselect },
+    { "energy",  bench_energy },
+    { "logrec",  bench_logrec },
+    { "logexport", bench_logexport },
+    { "coldstart", bench_coldstart },
+};
+
+#define BENCH_COUNT (int)(sizeof(benches) / sizeof(benches[0]))
+
+int main(int argc, char *argv[])
+{
+    int i, ran = 0;
+
+    for (i = 0; i < BENCH_COUNT; i++) {
+        if (argc > 1 && strcmp(argv[1], benches[i].name) != 0) continue;
+        benches[i].run();
+        ran++;
+    }
+    if (!ran) {
+        fprintf(stderr, "Unknown benchmark '%s'. Available:", argv[1]);
+        for (i = 0; i < BENCH_COUNT; i++) fprintf(stderr, " %s", benches[i].name);
+        fprintf(stderr, "\n");
+        return 1;
+    }
+    return 0;
+}
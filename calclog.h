@@ -0,0 +1,56 @@
+#ifndef CALCLOG_H
+#define CALCLOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Calculation log
+// Every record is one frame: a 4-byte magic, the payload length and the
+// CRC-32 of the payload, then the payload. A frame is appended with a
+// single write() on an O_APPEND descriptor, so concurrent writers never
+// interleave within a record. Writers hold a shared advisory lock for the
+// append (no contention between them) and clearing takes the exclusive
+// lock, so a truncate never meets a half-written record. A record torn by
+// a crash fails its length or CRC check and the scan resynchronizes on
+// the next magic.
+//
+// "main.out log view|check|clear [--file calc_log.bin]"
+// "main.out log append <text> [--file calc_log.bin]"
+// "main.out log export ..." (see logexport.h)
+
+#define LOG_FILENAME    "calc_log.bin"
+
+#define CLOG_MAGIC      0x31474c43u   // "CLG1" in the file (little endian)
+#define CLOG_HEADER     12
+#define CLOG_MAX_RECORD (64 * 1024)
+
+typedef struct {
+    long   records;       // valid records visited
+    long   torn;          // damaged regions skipped
+    size_t skipped;       // bytes in them
+} clog_stats;
+
+// Called for each valid record; a nonzero return stops the scan
+typedef int (*clog_visit)(const void *data, size_t len, void *ctx);
+
+uint32_t clog_crc32(const void *data, size_t len);
+
+// 0 on success, -1 on error (errno set)
+int clog_append(const char *path, const void *data, size_t len);
+int clog_clear(const char *path);
+
+// Visits the valid records of a log image, skipping torn ones
+void clog_scan_buffer(const unsigned char *buf, size_t size, clog_visit visit, void *ctx,
+                      clog_stats *st);
+
+// Same on a file (memory-mapped); a missing file has no records.
+// Returns 0, or -1 if the file cannot be read.
+int clog_scan(const char *path, clog_visit visit, void *ctx, clog_stats *st);
+
+// Offset of the first valid frame at or after pos (size if none), for
+// splitting a log image into pieces that scan independently
+size_t clog_sync(const unsigned char *buf, size_t size, size_t pos);
+
+int clog_main(int argc, char *argv[]);
+
+#endif
@@ -0,0 +1,538 @@
+// Command line subcommands
+// Each subcommand parses its arguments, calls the kernels in funcs.c and
+// prints only the result so it can be used from shell pipelines.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "funcs.h"
+#include "cli.h"
+#include "repl.h"
+#include "batch.h"
+#include "labels.h"
+#include "bandscan.h"
+#include "marking.h"
+#include "smd.h"
+#include "inventory.h"
+#include "divider.h"
+#include "rcselect.h"
+#include "energy.h"
+#include "calclog.h"
+#include "arena.h"
+#include "textio.h"
+#include "scheduler.h"
+#include "topology.h"
+#include "reduce.h"
+#include "montecarlo.h"
+#include "interval.h"
+
+#define PI 3.14159265358979323846
+
+// One "--name value" option (value == NULL means a plain flag)
+typedef struct {
+    const char *name;
+    double     *value;
+    int        *seen;
+} cli_opt_t;
+
+typedef struct {
+    const char *name;
+    int       (*run)(int argc, char *argv[]);
+    const char *usage;
+} cli_command_t;
+
+// Parses "--name value" pairs, values may use SI suffixes
+// Returns 0 on success, -1 (with a message) on bad input
+static int cli_parse_opts(int argc, char *argv[], const cli_opt_t opts[], int nopts)
+{
+    int i, j;
+
+    for (i = 1; i < argc; i++) {
+        for (j = 0; j < nopts; j++)
+            if (strcmp(argv[i], opts[j].name) == 0) break;
+
+        if (j == nopts) {
+            fprintf(stderr, "%s: unknown option '%s'\n", argv[0], argv[i]);
+            return -1;
+        }
+
+        if (opts[j].value) {
+            if (i + 1 >= argc || parse_si_value(argv[i + 1], opts[j].value) != 0) {
+                fprintf(stderr, "%s: %s needs a number\n", argv[0], opts[j].name);
+                return -1;
+            }
+            i++;
+        }
+        if (opts[j].seen) *opts[j].seen = 1;
+    }
+    return 0;
+}
+
+// Parses positional values (resistor lists) into a float array from the
+// request arena, returns the count or -1
+static int cli_parse_values(int argc, char *argv[], float **values)
+{
+    int i;
+    double v;
+
+    if (argc < 2) {
+        fprintf(stderr, "%s: expected at least one value\n", argv[0]);
+        return -1;
+    }
+    *values = arena_alloc(&request_arena, sizeof(float) * (argc - 1));
+    if (!*values) {
+        fprintf(stderr, "%s: out of memory\n", argv[0]);
+        return -1;
+    }
+    for (i = 1; i < argc; i++) {
+        if (parse_si_value(argv[i], &v) != 0 || v <= 0.0) {
+            fprintf(stderr, "%s: bad value '%s'\n", argv[0], argv[i]);
+            return -1;
+        }
+        (*values)[i - 1] = (float)v;
+    }
+    return argc - 1;
+}
+
+// ohm --V 5 --R 1k  (any two of V, I, R, P)
+static int cli_ohm(int argc, char *argv[])
+{
+    double V = 0, I = 0, R = 0, P = 0;
+    int rc;
+    const cli_opt_t opts[] = {
+        { "--V", &V, NULL }, { "--I", &I, NULL },
+        { "--R", &R, NULL }, { "--P", &P, NULL },
+    };
+
+    if (cli_parse_opts(argc, argv, opts, 4) != 0) return 1;
+    rc = (V < 0 || I < 0 || R < 0 || P < 0) ? -1 : solve_ohm(&V, &I, &R, &P);
+    if (rc == -2) {
+        fprintf(stderr, "ohm: value out of range\n");
+        return 1;
+    }
+    if (rc != 0) {
+        fprintf(stderr, "ohm: give exactly two positive values of --V --I --R --P\n");
+        return 1;
+    }
+    printf("V=%.6g I=%.6g R=%.6g P=%.6g\n", V, I, R, P);
+    return 0;
+}
+
+// decode red red brown [gold]
+static int cli_decode(int argc, char *argv[])
+{
+    const char *tol = (argc == 5) ? argv[4] : NULL;
+    float R;
+
+    if (argc != 4 && argc != 5) {
+        fprintf(stderr, "decode: expected 3 or 4 band colors\n");
+        return 1;
+    }
+    R = decode_resistor(argv[1], argv[2], argv[3], tol);
+    if (R < 0.0f) {
+        fprintf(stderr, "decode: unknown band color\n");
+        return 1;
+    }
+    printf("%.6g %g%%\n", R, get_tolerance(tol));
+    return 0;
+}
+
+// encode 4k7
+static int cli_encode(int argc, char *argv[])
+{
+    const char *stock = NULL, *value = NULL;
+    double R, err = 5;
+    int d1, d2, m, i, bad = 0;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--stock") == 0 && i + 1 < argc) stock = argv[++i];
+        else if (strcmp(argv[i], "--err") == 0 && i + 1 < argc)
+            bad |= (parse_si_value(argv[++i], &err) != 0 || err < 0);
+        else if (!value) value = argv[i];
+        else bad = 1;
+    }
+    if (bad || !value || parse_si_value(value, &R) != 0) {
+        fprintf(stderr, "encode: expected one resistance\n");
+        return 1;
+    }
+
+    // encode the closest part in stock instead of the exact value
+    if (stock) {
+        inventory db;
+        int k;
+
+        if (inv_open(&db, stock) != 0) {
+            fprintf(stderr, "encode: cannot open inventory '%s'\n", stock);
+            return 1;
+        }
+        k = inv_find(&db, R, err / 100, INV_ANY_PACKAGE, 1);
+        if (k >= 0) R = db.value[k];
+        inv_close(&db);
+        if (k < 0) {
+            fprintf(stderr, "encode: no part in stock within %g%%\n", err);
+            return 1;
+        }
+        printf("%.6g: ", R);
+    }
+
+    if (encode_resistor(R, &d1, &d2, &m) != 0) {
+        fprintf(stderr, "encode: resistance out of range\n");
+        return 1;
+    }
+    printf("%s %s %s\n", color_name(d1), color_name(d2), color_name(m));
+    return 0;
+}
+
+// series 1k 2k2 330
+static int cli_series(int argc, char *argv[])
+{
+    float *R, total;
+    int n = cli_parse_values(argc, argv, &R);
+
+    if (n < 0) return 1;
+    total = calc_series(R, n);
+    if (isnan(total)) {
+        fprintf(stderr, "series: value out of range\n");
+        return 1;
+    }
+    printf("%.6g\n", total);
+    return 0;
+}
+
+// parallel 1k 1k
+static int cli_parallel(int argc, char *argv[])
+{
+    float *R, total;
+    int n = cli_parse_values(argc, argv, &R);
+
+    if (n < 0) return 1;
+    total = calc_parallel(R, n);
+    if (isnan(total)) {
+        fprintf(stderr, "parallel: value out of range\n");
+        return 1;
+    }
+    printf("%.6g\n", total);
+    return 0;
+}
+
+// rc --R 10k --C 1u --t 5m [--V 5] [--discharge]
+static int cli_rc(int argc, char *argv[])
+{
+    double R = 0, C = 0, t = -1, V = 1.0;
+    int discharge = 0;
+    float v;
+    const cli_opt_t opts[] = {
+        { "--R", &R, NULL }, { "--C", &C, NULL }, { "--t", &t, NULL },
+        { "--V", &V, NULL }, { "--discharge", NULL, &discharge },
+    };
+
+    if (cli_parse_opts(argc, argv, opts, 5) != 0) return 1;
+    if (R <= 0 || C <= 0 || t < 0) {
+        fprintf(stderr, "rc: --R, --C and --t are required\n");
+        return 1;
+    }
+    v = discharge ? rc_discharge((float)R, (float)C, (float)V, (float)t)
+                  : rc_charge((float)R, (float)C, (float)V, (float)t);
+    if (isnan(v)) {
+        fprintf(stderr, "rc: value out of range\n");
+        return 1;
+    }
+    printf("%.6g\n", v);
+    return 0;
+}
+
+// period --f 50
+static int cli_period(int argc, char *argv[])
+{
+    double f = 0;
+    const cli_opt_t opts[] = { { "--f", &f, NULL } };
+
+    if (cli_parse_opts(argc, argv, opts, 1) != 0) return 1;
+    if (f <= 0) {
+        fprintf(stderr, "period: --f is required\n");
+        return 1;
+    }
+    printf("T=%.6g w=%.6g\n", 1.0 / f, 2 * PI * f);
+    return 0;
+}
+
+typedef struct {
+    double  A, f, fs;
+    double *x;
+} cli_sine_job;
+
+static void cli_sine_chunk(size_t lo, size_t hi, void *arg)
+{
+    const cli_sine_job *j = arg;
+    sine_batch(j->A, j->f, j->fs, (long)lo, j->x + lo, (int)(hi - lo));
+}
+
+// sine --f 50 --A 1 --fs 1k --N 20 [--threads 4] [--numa]
+static int cli_sine(int argc, char *argv[])
+{
+    double f = 0, A = 1.0, fs = 0, N = 0, threads = 0;
+    int numa = 0;
+    size_t n, count, bytes;
+    cli_sine_job job;
+    textio_out out;
+    const cli_opt_t opts[] = {
+        { "--f", &f, NULL }, { "--A", &A, NULL },
+        { "--fs", &fs, NULL }, { "--N", &N, NULL },
+        { "--threads", &threads, NULL }, { "--numa", NULL, &numa },
+    };
+
+    if (cli_parse_opts(argc, argv, opts, 6) != 0) return 1;
+    if (f <= 0 || fs <= 0 || N < 1 || N > 2e9) {
+        fprintf(stderr, "sine: --f, --fs and --N are required\n");
+        return 1;
+    }
+    count = (size_t)N;
+    bytes = sizeof(double) * count;
+    if (threads > 0) sched_set_threads((int)threads);
+
+    // with --numa each worker first-touches the block it generates
+    job.A = A;
+    job.f = f;
+    job.fs = fs;
+    job.x = numa ? topo_alloc(bytes) : arena_alloc(&request_arena, bytes);
+    if (!job.x) {
+        fprintf(stderr, "sine: out of memory\n");
+        return 1;
+    }
+    if (numa) parallel_for_static(0, count, cli_sine_chunk, &job);
+    else parallel_for(0, count, 65536, cli_sine_chunk, &job);
+
+    textio_out_open(&out, stdout);
+    for (n = 0; n < count; n++)
+        textio_printf(&out, "%zu %.6g %.6g\n", n, n / fs, job.x[n]);
+    textio_out_close(&out);
+
+    if (numa) topo_free(job.x, bytes);
+    return 0;
+}
+
+// mc series|parallel [--tol 5] [--N 100k] [--seed 1] [--normal]
+//    [--threads N] [--deterministic] R1 R2 ...
+static int cli_mc(int argc, char *argv[])
+{
+    double tol = 5.0, N = 100000, seed = 1, threads = 0;
+    int normal = 0, det = 0, i, j, n = 0;
+    double *R;
+    mc_network net;
+    reduce_stats st;
+    const cli_opt_t opts[] = {
+        { "--tol", &tol, NULL }, { "--N", &N, NULL }, { "--seed", &seed, NULL },
+        { "--threads", &threads, NULL }, { "--normal", NULL, &normal },
+        { "--deterministic", NULL, &det },
+    };
+    const int nopts = (int)(sizeof(opts) / sizeof(opts[0]));
+    char *optv[32];
+    int optc = 1;
+
+    if (argc < 3 || (strcmp(argv[1], "series") != 0 && strcmp(argv[1], "parallel") != 0)) {
+        fprintf(stderr, "mc: expected series or parallel and resistor values\n");
+        return 1;
+    }
+    R = arena_alloc(&request_arena, sizeof(double) * argc);
+    if (!R) return 1;
+
+    // options go to cli_parse_opts, everything else is a resistor value
+    optv[0] = argv[0];
+    for (i = 2; i < argc; i++) {
+        for (j = 0; j < nopts; j++)
+            if (strcmp(argv[i], opts[j].name) == 0) break;
+        if (j < nopts) {
+            if (optc + 2 >= 32) return 1;
+            optv[optc++] = argv[i];
+            if (opts[j].value && i + 1 < argc) optv[optc++] = argv[++i];
+        } else if (parse_si_value(argv[i], &R[n]) != 0 || R[n] <= 0.0) {
+            fprintf(stderr, "mc: bad value '%s'\n", argv[i]);
+            return 1;
+        } else {
+            n++;
+        }
+    }
+    if (cli_parse_opts(optc, optv, opts, nopts) != 0) return 1;
+    if (n == 0 || tol < 0 || tol >= 100 || N < 1 || N > 1e12) {
+        fprintf(stderr, "mc: need resistor values, 0 <= --tol < 100 and --N >= 1\n");
+        return 1;
+    }
+    if (threads > 0) sched_set_threads((int)threads);
+    if (det) reduce_set_deterministic(1);
+
+    net.R = R;
+    net.n = n;
+    net.parallel = argv[1][0] == 'p';
+    net.tol = tol / 100.0;
+    net.normal = normal;
+    net.seed = (uint64_t)seed;
+    mc_run(&net, (size_t)N, &st);
+
+    printf("mean=%.17g std=%.17g min=%.17g max=%.17g N=%zu\n",
+           st.sum / st.n, sqrt(fmax(st.sumsq / st.n - (st.sum / st.n) * (st.sum / st.n), 0.0)),
+           st.min, st.max, st.n);
+    return 0;
+}
+
+// A toleranced value: "4k7@5" (5%), "4k7" (exact) or a color code
+// "yellow-violet-red-gold" whose tolerance band gives the range
+static int cli_parse_ival(const char *s, ival *out)
+{
+    char buf[128], *band[4] = { NULL }, *at, *p;
+    double v, pct = 0.0;
+    int n = 0;
+
+    if (strlen(s) >= sizeof(buf)) return -1;
+    strcpy(buf, s);
+
+    if (strchr(buf, '-')) {
+        for (p = strtok(buf, "-"); p && n < 4; p = strtok(NULL, "-")) band[n++] = p;
+        if (n < 3 || p) return -1;
+        return ival_decode_resistor(band[0], band[1], band[2], band[3], out);
+    }
+    if ((at = strchr(buf, '@'))) {
+        *at = '\0';
+        if (parse_si_value(at + 1, &pct) != 0 || pct < 0 || pct >= 100) return -1;
+    }
+    if (parse_si_value(buf, &v) != 0 || v < 0) return -1;
+    *out = ival_tol(v, pct);
+    return 0;
+}
+
+// All 17 digits: a shorter form could round a bound inward
+static void cli_print_ival(const char *name, ival x)
+{
+    printf("%s=[%.17g, %.17g]\n", name, x.lo, x.hi);
+}
+
+// bounds series|parallel R1 R2 ...
+// bounds ohm --V 5@1 --R 1k@5
+// bounds rc --R 10k@5 --C 1u@10 --t 5m [--V 5] [--discharge]
+static int cli_bounds(int argc, char *argv[])
+{
+    ival V = { 1.0, 1.0 }, R = { 0, 0 }, C = { 0, 0 }, t = { -1, -1 };
+    struct { const char *name; ival *value; } opts[] = {
+        { "--V", &V }, { "--R", &R }, { "--C", &C }, { "--t", &t },
+    };
+    int i, j, n = 0, discharge = 0;
+    ival *r;
+
+    if (argc < 3) {
+        fprintf(stderr, "bounds: expected series, parallel, ohm or rc and values\n");
+        return 1;
+    }
+
+    if (strcmp(argv[1], "series") == 0 || strcmp(argv[1], "parallel") == 0) {
+        r = arena_alloc(&request_arena, sizeof(ival) * argc);
+        if (!r) return 1;
+        for (i = 2; i < argc; i++, n++) {
+            if (cli_parse_ival(argv[i], &r[n]) != 0 || r[n].lo <= 0.0) {
+                fprintf(stderr, "bounds: bad value '%s'\n", argv[i]);
+                return 1;
+            }
+        }
+        cli_print_ival("R", argv[1][0] == 's' ? ival_series(r, n) : ival_parallel(r, n));
+        return 0;
+    }
+
+    for (i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--discharge") == 0) { discharge = 1; continue; }
+        for (j = 0; j < 4; j++)
+            if (strcmp(argv[i], opts[j].name) == 0) break;
+        if (j == 4 || i + 1 >= argc || cli_parse_ival(argv[i + 1], opts[j].value) != 0) {
+            fprintf(stderr, "bounds: bad option '%s'\n", argv[i]);
+            return 1;
+        }
+        i++;
+    }
+
+    if (strcmp(argv[1], "ohm") == 0) {
+        ival I;
+        if (R.lo <= 0.0) {
+            fprintf(stderr, "bounds: ohm needs --V and --R\n");
+            return 1;
+        }
+        I = ival_current(V, R);
+        cli_print_ival("I", I);
+        cli_print_ival("P", ival_power(V, I));
+        return 0;
+    }
+    if (strcmp(argv[1], "rc") == 0) {
+        if (R.lo <= 0.0 || C.lo <= 0.0 || t.lo < 0.0) {
+            fprintf(stderr, "bounds: rc needs --R, --C and --t\n");
+            return 1;
+        }
+        cli_print_ival("Vc", discharge ? ival_rc_discharge(R, C, V, t) : ival_rc_charge(R, C, V, t));
+        return 0;
+    }
+    fprintf(stderr, "bounds: unknown kind '%s'\n", argv[1]);
+    return 1;
+}
+
+// repl ["expression" ...]  (no expressions = read lines from stdin)
+static int cli_repl(int argc, char *argv[])
+{
+    int i, status = 0;
+
+    if (argc == 1) {
+        repl_run();
+        return 0;
+    }
+    for (i = 1; i < argc; i++)
+        if (repl_eval_line(argv[i]) != 0) status = 1;
+    return status;
+}
+
+static const cli_command_t cli_commands[] = {
+    { "ohm",      cli_ohm,      "ohm --V 5 --R 1k        (any two of --V --I --R --P)" },
+    { "decode",   cli_decode,   "decode red red brown [gold]" },
+    { "encode",   cli_encode,   "encode 4k7 [--stock parts.db [--err 5]]" },
+    { "series",   cli_series,   "series 1k 2k2 330" },
+    { "parallel", cli_parallel, "parallel 1k 1k" },
+    { "rc",       cli_rc,       "rc --R 10k --C 1u --t 5m [--V 5] [--discharge]" },
+    { "period",   cli_period,   "period --f 50" },
+    { "sine",     cli_sine,     "sine --f 50 --fs 1k --N 20 [--A 1] [--threads N] [--numa]" },
+    { "mc",       cli_mc,       "mc series|parallel [--tol 5] [--N 100k] [--seed 1] [--normal] [--deterministic] R1 R2 ..." },
+    { "labels",   labels_main,  "labels <in.csv> [--bands 4|5|6] [--tol 1] [--format names|index|rgb] [-o out]" },
+    { "marking",  marking_main, "marking resistor|inductor|capacitor|eia96 <code>... | --file codes.txt" },
+    { "smd",      smd_main,     "smd decode <code>... | smd encode [--style 3|4|eia96] <ohms>...  (--file, -o)" },
+    { "divider",  divider_main, "divider --ratio 0.25 | --vin 12 --vout 3.3 [--series E24] [--imin] [--imax] [--zmax] [--legs 2]" },
+    { "rcselect", rcselect_main, "rcselect --tau 1m | --fc 1k [--tol 2] [--rseries E24] [--cseries E12] [--top 5] [--N 10k]" },
+    { "energy",   energy_main,  "energy <profile.csv | -> [--capacity 2000m --vbat 3.7 | --wh 7.4] [--efficiency 90]" },
+    { "log",      clog_main,    "log view|check|clear | log append <text> | log export --format csv|jsonl|col -o out  [--file calc_log.bin]" },
+    { "inventory", inventory_main, "inventory build <parts.csv> -o parts.db | find <parts.db> <ohms>... | stats <parts.db>" },
+    { "scan",     scan_main,    "scan [frame.ppm ...]    (P6 frames, stdin if no files)" },
+    { "bounds",   cli_bounds,   "bounds series|parallel|ohm|rc 4k7@5 red-red-brown-gold ... (guaranteed min/max)" },
+    { "batch",    batch_main,   "batch <kind> <in.csv> [-o out.csv] [--threads N] [--numa] [--sum] [--stats] [--series E24] [--journal f]" },
+    { "repl",     cli_repl,     "repl [\"par(10k, 4k7)\" ...]" },
+};
+
+#define CLI_COMMAND_COUNT (int)(sizeof(cli_commands) / sizeof(cli_commands[0]))
+
+static const cli_command_t *cli_find(const char *name)
+{
+    int i;
+    for (i = 0; i < CLI_COMMAND_COUNT; i++)
+        if (strcmp(cli_commands[i].name, name) == 0) return &cli_commands[i];
+    return NULL;
+}
+
+int cli_is_command(const char *name)
+{
+    return cli_find(name) != NULL;
+}
+
+int cli_run(int argc, char *argv[])
+{
+    const cli_command_t *c = cli_find(argv[0]);
+    return c ? c->run(argc, argv) : 1;
+}
+
+void cli_print_usage(const char *prog)
+{
+    int i;
+    fprintf(stderr, "Subcommands:\n");
+    for (i = 0; i < CLI_COMMAND_COUNT; i++)
+        fprintf(stderr, "  %s %s\n", prog, cli_commands[i].usage);
+}
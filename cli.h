@@ -0,0 +1,17 @@
+#ifndef CLI_H
+#define CLI_H
+
+// Scriptable command line interface
+// "main.out <subcommand> [args]" runs one calculation, prints only the
+// result on stdout and exits, without entering the interactive menus.
+
+// Returns 1 if name is a known subcommand
+int cli_is_command(const char *name);
+
+// Runs argv[0] as a subcommand, returns the process exit code
+int cli_run(int argc, char *argv[]);
+
+// Prints the subcommand list (used by --help)
+void cli_print_usage(const char *prog);
+
+#endif
@@ -0,0 +1,239 @@
+// Voltage divider designer
+// Every leg value (single parts, and with legs = 2 every series pair
+// whose second part is 1/100 .. 1 of the first) is built once into a
+// sorted array. The ideal R1 for each R2 is k * R2 with k = (1 - r) / r,
+// which grows with R2, so one two-pointer sweep over both arrays finds the
+// nearest R1 for every R2 in O(n1 + n2) instead of trying all pairs.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "funcs.h"
+#include "arena.h"
+#include "eseries.h"
+#include "inventory.h"
+#include "divider.h"
+
+#define DIV_MAX_VALUES 4096     // series values per leg range
+#define DIV_MAX_TOP    100
+#define DIV_TRIM_MIN   0.01     // smallest second part, relative to the first
+
+// Default total resistance when no current limit is given
+#define DIV_RTOT_MIN   100.0
+#define DIV_RTOT_MAX   10e6
+
+typedef struct {
+    double v, a, b;             // leg value = a + b (b = 0 for one part)
+} div_leg;
+
+static int leg_cmp(const void *x, const void *y)
+{
+    const div_leg *p = x, *q = y;
+
+    if (p->v != q->v) return p->v < q->v ? -1 : 1;
+    return (p->b > 0) - (q->b > 0);        // single part first
+}
+
+// Sorted leg values in [lo, hi], one entry per distinct value (the one
+// with the fewest parts); returns the count or -1 if out of memory
+static int div_legs(const div_spec *s, double lo, double hi, div_leg **out)
+{
+    double *base = arena_alloc(&request_arena, sizeof(double) * DIV_MAX_VALUES);
+    double part_lo = (s->legs > 1) ? lo * DIV_TRIM_MIN / (1 + DIV_TRIM_MIN) : lo;
+    div_leg *leg;
+    int nb, i, j, n = 0, cap;
+
+    if (!base) return -1;
+    nb = eseries_range(s->series, part_lo, hi, base, DIV_MAX_VALUES);
+
+    if (s->stock) {
+        for (i = j = 0; i < nb; i++)
+            if (inv_find(s->stock, base[i], 1e-6, INV_ANY_PACKAGE, 1) >= 0) base[j++] = base[i];
+        nb = j;
+    }
+
+    // pairs: for each first part, the trims run over at most two decades
+    cap = nb + (s->legs > 1 ? nb * 2 * s->series + 1 : 0);
+    if (!(leg = arena_alloc(&request_arena, sizeof(div_leg) * cap))) return -1;
+
+    for (i = 0; i < nb; i++) {
+        if (base[i] >= lo) leg[n++] = (div_leg){ base[i], base[i], 0 };
+        if (s->legs < 2) continue;
+        for (j = i; j >= 0 && base[j] >= base[i] * DIV_TRIM_MIN && n < cap; j--) {
+            double v = base[i] + base[j];
+            if (v >= lo && v <= hi) leg[n++] = (div_leg){ v, base[i], base[j] };
+        }
+    }
+    qsort(leg, (size_t)n, sizeof(div_leg), leg_cmp);
+
+    for (i = j = 0; i < n; i++)
+        if (j == 0 || leg[i].v != leg[j - 1].v) leg[j++] = leg[i];
+    *out = leg;
+    return j;
+}
+
+// Orders designs: smaller ratio error, then fewer parts, then a total
+// resistance nearer the middle of the allowed range (on a log scale)
+static int div_better(const div_result *x, const div_result *y, double rtot_mid)
+{
+    int px = (x->r1[1] > 0) + (x->r2[1] > 0), py = (y->r1[1] > 0) + (y->r2[1] > 0);
+
+    if (fabs(x->err) != fabs(y->err)) return fabs(x->err) < fabs(y->err);
+    if (px != py) return px < py;
+    return fabs(log((x->R1 + x->R2) / rtot_mid)) < fabs(log((y->R1 + y->R2) / rtot_mid));
+}
+
+int divider_design(const div_spec *s, div_result out[], int top)
+{
+    arena_mark_t mark = arena_mark(&request_arena);
+    double r = s->ratio, k, rtot_min, rtot_max, rtot_mid;
+    div_leg *l1, *l2;
+    int n1, n2, i, j, found = 0;
+
+    if (!(r > 0 && r < 1) || top < 1 || eseries_mantissas(s->series, NULL) < 0 ||
+        s->legs < 1 || s->legs > DIV_MAX_LEG) return -1;
+
+    rtot_min = (s->imax > 0) ? s->vin / s->imax : DIV_RTOT_MIN;
+    rtot_max = (s->imin > 0) ? s->vin / s->imin : DIV_RTOT_MAX;
+    if (s->zmax > 0 && s->zmax / (r * (1 - r)) < rtot_max) rtot_max = s->zmax / (r * (1 - r));
+    if (rtot_min > rtot_max) return 0;
+    rtot_mid = sqrt(rtot_min * rtot_max);
+
+    // leg ranges with some slack for the ratio error, the exact limits
+    // are checked on every candidate
+    n2 = div_legs(s, r * rtot_min * 0.9, r * rtot_max * 1.1, &l2);
+    n1 = div_legs(s, (1 - r) * rtot_min * 0.9, (1 - r) * rtot_max * 1.1, &l1);
+    if (n1 < 0 || n2 < 0) {
+        arena_release(&request_arena, mark);
+        return -1;
+    }
+
+    k = (1 - r) / r;
+    for (i = 0, j = 0; i < n2 && n1 > 0; i++) {
+        double want = k * l2[i].v;
+        int c;
+
+        while (j + 1 < n1 && l1[j + 1].v <= want) j++;
+        for (c = j; c <= j + 1 && c < n1; c++) {
+            double R1 = l1[c].v, R2 = l2[i].v, rtot = R1 + R2;
+            div_result d;
+            int pos;
+
+            if (rtot < rtot_min || rtot > rtot_max) continue;
+            if (s->zmax > 0 && R1 * R2 / rtot > s->zmax) continue;
+
+            d.r1[0] = l1[c].a; d.r1[1] = l1[c].b;
+            d.r2[0] = l2[i].a; d.r2[1] = l2[i].b;
+            d.R1 = R1;
+            d.R2 = R2;
+            d.ratio = R2 / rtot;
+            d.err = (d.ratio - r) / r;
+
+            // insertion into the ranked list
+            if (found == top && !div_better(&d, &out[top - 1], rtot_mid)) continue;
+            pos = (found < top) ? found++ : top - 1;
+            while (pos > 0 && div_better(&d, &out[pos - 1], rtot_mid)) {
+                out[pos] = out[pos - 1];
+                pos--;
+            }
+            out[pos] = d;
+        }
+    }
+
+    arena_release(&request_arena, mark);
+    return found;
+}
+
+// ---- Command line ----
+
+static void div_usage(void)
+{
+    fprintf(stderr, "Usage: main.out divider --ratio 0.25 | --vin 12 --vout 3.3\n"
+                    "                        [--series E24] [--imin 10u] [--imax 1m] [--zmax 10k]\n"
+                    "                        [--legs 1|2] [--top 10] [--stock parts.db]\n");
+}
+
+static void div_print_leg(const double part[DIV_MAX_LEG])
+{
+    if (part[1] > 0) printf("%.6g+%.6g", part[0], part[1]);
+    else printf("%.6g", part[0]);
+}
+
+int divider_main(int argc, char *argv[])
+{
+    const char *stock_path = NULL;
+    double vout = -1, legs = 1, top = 10;
+    div_spec s = { 0 };
+    div_result *res;
+    inventory db;
+    int i, n;
+
+    s.vin = 1;
+    s.ratio = -1;
+    s.series = 24;
+    for (i = 1; i < argc; i++) {
+        double *opt = strcmp(argv[i], "--ratio") == 0 ? &s.ratio :
+                      strcmp(argv[i], "--vin") == 0 ? &s.vin :
+                      strcmp(argv[i], "--vout") == 0 ? &vout :
+                      strcmp(argv[i], "--imin") == 0 ? &s.imin :
+                      strcmp(argv[i], "--imax") == 0 ? &s.imax :
+                      strcmp(argv[i], "--zmax") == 0 ? &s.zmax :
+                      strcmp(argv[i], "--legs") == 0 ? &legs :
+                      strcmp(argv[i], "--top") == 0 ? &top : NULL;
+
+        if (strcmp(argv[i], "--series") == 0 && i + 1 < argc) {
+            if ((s.series = eseries_parse(argv[++i])) < 0) { div_usage(); return 1; }
+        } else if (strcmp(argv[i], "--stock") == 0 && i + 1 < argc) {
+            stock_path = argv[++i];
+        } else if (!opt || i + 1 >= argc || parse_si_value(argv[++i], opt) != 0) {
+            div_usage();
+            return 1;
+        }
+    }
+    if (vout >= 0) s.ratio = (s.vin > 0) ? vout / s.vin : -1;
+    if (!(s.ratio > 0 && s.ratio < 1) || s.vin <= 0 || top < 1 || top > DIV_MAX_TOP ||
+        !(legs >= 1 && legs <= DIV_MAX_LEG) || legs != (int)legs) {
+        div_usage();
+        return 1;
+    }
+
+    s.legs = (int)legs;
+
+    if (stock_path) {
+        if (inv_open(&db, stock_path) != 0) {
+            fprintf(stderr, "divider: cannot open inventory '%s'\n", stock_path);
+            return 1;
+        }
+        s.stock = &db;
+    }
+
+    res = arena_alloc(&request_arena, sizeof(div_result) * (size_t)top);
+    n = res ? divider_design(&s, res, (int)top) : -1;
+    if (s.stock) inv_close(&db);
+    if (n < 0) {
+        fprintf(stderr, "divider: out of memory\n");
+        return 1;
+    }
+    if (n == 0) {
+        fprintf(stderr, "divider: no E%d design meets the limits\n", s.series);
+        arena_reset(&request_arena);
+        return 1;
+    }
+
+    printf("rank,R1,R2,ratio,error_ppm,Vout,I,Zout\n");
+    for (i = 0; i < n; i++) {
+        double rtot = res[i].R1 + res[i].R2, ppm = res[i].err * 1e6;
+
+        if (fabs(ppm) < 0.5) ppm = 0;      // no "-0"
+
+        printf("%d,", i + 1);
+        div_print_leg(res[i].r1);
+        printf(",");
+        div_print_leg(res[i].r2);
+        printf(",%.6f,%+.0f,%.6g,%.6g,%.6g\n", res[i].ratio, ppm,
+               s.vin * res[i].ratio, s.vin / rtot, res[i].R1 * res[i].R2 / rtot);
+    }
+    arena_reset(&request_arena);
+    return 0;
+}
@@ -0,0 +1,39 @@
+#ifndef DIVIDER_H
+#define DIVIDER_H
+
+#include "inventory.h"
+
+// Voltage divider designer
+// Finds E-series R1 (top) / R2 (bottom) pairs for Vout/Vin = R2/(R1+R2),
+// ranked by ratio error, within limits on divider current and output
+// impedance. Each leg may be one resistor or two in series (legs = 2),
+// which gets E24 parts within a few ppm of most ratios.
+//
+// "main.out divider --ratio 0.25 | --vin 12 --vout 3.3 [--series E24]
+//  [--imin 10u] [--imax 1m] [--zmax 10k] [--legs 2] [--top 10] [--stock parts.db]"
+
+#define DIV_MAX_LEG 2
+
+typedef struct {
+    double ratio;              // Vout / Vin
+    double vin;                // only for the current limits and the report
+    double imin, imax;         // divider current limits, 0 = none
+    double zmax;               // output impedance R1 || R2 limit, 0 = none
+    int    series;             // 3 .. 192
+    int    legs;               // resistors per leg, 1 .. DIV_MAX_LEG
+    const inventory *stock;    // only use values in stock, NULL = any
+} div_spec;
+
+typedef struct {
+    double r1[DIV_MAX_LEG], r2[DIV_MAX_LEG];    // parts of each leg, 0 = unused
+    double R1, R2;
+    double ratio, err;                          // err relative to the target
+} div_result;
+
+// Best `top` designs, best first; returns how many were found (-1 if the
+// spec is invalid or memory ran out)
+int divider_design(const div_spec *s, div_result out[], int top);
+
+int divider_main(int argc, char *argv[]);
+
+#endif
@@ -0,0 +1,242 @@
+// Energy and battery runtime of a load profile
+// The profile is read in ENERGY_BUF chunks and parsed into columnar
+// blocks of ENERGY_BLOCK samples. Each block goes through power_batch()
+// (t,V,I profiles) and the trapezoid kernel, and only the last sample is
+// carried over to the next block, so memory use does not grow with the
+// profile length.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "funcs.h"
+#include "arena.h"
+#include "energy.h"
+
+#define ENERGY_BLOCK 16384
+#define ENERGY_BUF   (256 * 1024)
+
+void energy_init(energy_acc *a)
+{
+    memset(a, 0, sizeof(*a));
+}
+
+// Trapezoid rule: the segment sums run in four independent accumulators,
+// so the adds do not wait on one serial dependency chain (a compiler will
+// not reassociate a single floating-point sum on its own)
+int energy_add(energy_acc *a, const double t[], const double P[], int n)
+{
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0, lo, hi;
+    int i, backwards = 0;
+
+    if (n <= 0) return 0;
+    for (i = 1; i < n; i++) backwards |= (t[i] < t[i - 1]);
+    if (backwards || (a->samples && t[0] < a->t_last)) return -1;
+
+    if (a->samples) {
+        a->energy += 0.5 * (t[0] - a->t_last) * (a->p_last + P[0]);
+    } else {
+        a->t_first = t[0];
+        a->p_min = a->p_max = P[0];
+    }
+
+    for (i = 0; i + 4 < n; i += 4) {
+        s0 += (t[i + 1] - t[i]) * (P[i] + P[i + 1]);
+        s1 += (t[i + 2] - t[i + 1]) * (P[i + 1] + P[i + 2]);
+        s2 += (t[i + 3] - t[i + 2]) * (P[i + 2] + P[i + 3]);
+        s3 += (t[i + 4] - t[i + 3]) * (P[i + 3] + P[i + 4]);
+    }
+    for (; i + 1 < n; i++) s0 += (t[i + 1] - t[i]) * (P[i] + P[i + 1]);
+    a->energy += 0.5 * ((s0 + s1) + (s2 + s3));
+
+    lo = a->p_min;
+    hi = a->p_max;
+    for (i = 0; i < n; i++) {
+        lo = P[i] < lo ? P[i] : lo;
+        hi = P[i] > hi ? P[i] : hi;
+    }
+    a->p_min = lo;
+    a->p_max = hi;
+    a->t_last = t[n - 1];
+    a->p_last = P[n - 1];
+    a->samples += n;
+    return 0;
+}
+
+double energy_avg_power(const energy_acc *a)
+{
+    double span = a->t_last - a->t_first;
+    return (a->samples > 1 && span > 0) ? a->energy / span : 0.0;
+}
+
+// ---- Streaming reader ----
+
+typedef struct {
+    energy_acc *acc;
+    double     *t, *x, *y, *P;   // block columns: t,P in t/x, t,V,I in t/x/y
+    int         n, cols;
+    long        line;
+} energy_block;
+
+static int energy_flush(energy_block *b)
+{
+    if (b->cols == 3) power_batch(b->x, b->y, b->P, b->n);
+    if (energy_add(b->acc, b->t, b->cols == 3 ? b->P : b->x, b->n) != 0) {
+        fprintf(stderr, "energy: time goes backwards in the block ending at line %ld\n", b->line);
+        return -1;
+    }
+    b->n = 0;
+    return 0;
+}
+
+// Fields of one line separated by commas, semicolons or blanks; returns
+// the field count (0 for a blank line) or -1 if a field is not a number
+static int energy_fields(char *s, double v[3])
+{
+    int k = 0;
+
+    for (;;) {
+        char *end;
+
+        while (*s == ' ' || *s == '\t' || *s == '\r') s++;
+        if (!*s) return k;
+        if (k == 3) return -1;
+        v[k++] = strtod(s, &end);
+        if (end == s) return -1;
+        s = end;
+        while (*s == ' ' || *s == '\t' || *s == '\r') s++;
+        if (*s == ',' || *s == ';') s++;
+    }
+}
+
+static int energy_line(energy_block *b, char *s)
+{
+    double v[3];
+    int k = energy_fields(s, v);
+
+    b->line++;
+    if (k == 0) return 0;
+    if (k < 0 && b->line == 1) return 0;        // header
+    if (k < 2 || (b->cols && k != b->cols)) {
+        fprintf(stderr, "energy: line %ld needs %s\n", b->line,
+                b->cols == 3 ? "t,V,I" : b->cols == 2 ? "t,P" : "t,P or t,V,I");
+        return -1;
+    }
+    b->cols = k;
+    b->t[b->n] = v[0];
+    b->x[b->n] = v[1];
+    b->y[b->n] = v[2];
+    return (++b->n == ENERGY_BLOCK) ? energy_flush(b) : 0;
+}
+
+int energy_read(FILE *fp, energy_acc *a)
+{
+    arena_mark_t mark = arena_mark(&request_arena);
+    char *buf = arena_alloc(&request_arena, ENERGY_BUF + 1);
+    energy_block b;
+    size_t have = 0;
+    int status = 0, eof = 0;
+
+    memset(&b, 0, sizeof(b));
+    b.acc = a;
+    b.t = arena_alloc(&request_arena, sizeof(double) * ENERGY_BLOCK);
+    b.x = arena_alloc(&request_arena, sizeof(double) * ENERGY_BLOCK);
+    b.y = arena_alloc(&request_arena, sizeof(double) * ENERGY_BLOCK);
+    b.P = arena_alloc(&request_arena, sizeof(double) * ENERGY_BLOCK);
+    if (!buf || !b.t || !b.x || !b.y || !b.P) {
+        fprintf(stderr, "energy: out of memory\n");
+        arena_release(&request_arena, mark);
+        return -1;
+    }
+
+    while (status == 0 && !eof) {
+        size_t got = fread(buf + have, 1, ENERGY_BUF - have, fp);
+        char *p = buf, *end = buf + have + got;
+
+        eof = (got < ENERGY_BUF - have);
+        for (;;) {
+            char *nl = memchr(p, '\n', (size_t)(end - p));
+
+            if (!nl && (!eof || p == end)) break;
+            if (!nl) nl = end;                   // last line without a newline
+            *nl = '\0';
+            if ((status = energy_line(&b, p)) != 0) break;
+            p = (nl == end) ? end : nl + 1;
+        }
+        have = (size_t)(end - p);
+        memmove(buf, p, have);
+        if (status == 0 && have == ENERGY_BUF) {
+            fprintf(stderr, "energy: line %ld is too long\n", b.line + 1);
+            status = -1;
+        }
+    }
+    if (status == 0 && ferror(fp)) {
+        fprintf(stderr, "energy: read error\n");
+        status = -1;
+    }
+    if (status == 0 && b.n > 0) status = energy_flush(&b);
+
+    arena_release(&request_arena, mark);
+    return status;
+}
+
+// ---- Command line ----
+
+static void energy_usage(void)
+{
+    fprintf(stderr, "Usage: main.out energy <profile.csv | -> [--capacity 2000m --vbat 3.7 | --wh 7.4]\n"
+                    "                       [--efficiency 90]\n"
+                    "Profile columns: t,P or t,V,I (s, W, V, A)\n");
+}
+
+int energy_main(int argc, char *argv[])
+{
+    const char *path = NULL;
+    double capacity = 0, vbat = 0, wh = 0, efficiency = 100, avg;
+    energy_acc acc;
+    FILE *fp = stdin;
+    int i, status;
+
+    for (i = 1; i < argc; i++) {
+        double *opt = strcmp(argv[i], "--capacity") == 0 ? &capacity :
+                      strcmp(argv[i], "--vbat") == 0 ? &vbat :
+                      strcmp(argv[i], "--wh") == 0 ? &wh :
+                      strcmp(argv[i], "--efficiency") == 0 ? &efficiency : NULL;
+
+        if (opt) {
+            if (i + 1 >= argc || parse_si_value(argv[++i], opt) != 0) { energy_usage(); return 1; }
+        } else if (!path) {
+            path = argv[i];
+        } else {
+            energy_usage();
+            return 1;
+        }
+    }
+    if (!path || capacity < 0 || vbat < 0 || wh < 0 || !(efficiency > 0 && efficiency <= 100) ||
+        (capacity > 0 && vbat <= 0)) {
+        energy_usage();
+        return 1;
+    }
+    if (capacity > 0) wh = capacity * vbat;      // Ah * V
+
+    if (strcmp(path, "-") != 0 && !(fp = fopen(path, "r"))) {
+        fprintf(stderr, "energy: cannot read '%s'\n", path);
+        return 1;
+    }
+    energy_init(&acc);
+    status = energy_read(fp, &acc);
+    if (fp != stdin) fclose(fp);
+    if (status != 0) return 1;
+    if (acc.samples < 2) {
+        fprintf(stderr, "energy: the profile needs at least two samples\n");
+        return 1;
+    }
+
+    avg = energy_avg_power(&acc);
+    printf("samples=%ld duration=%.6g s\n", acc.samples, acc.t_last - acc.t_first);
+    printf("energy=%.6g J (%.6g Wh)\n", acc.energy, acc.energy / 3600);
+    printf("power avg=%.6g W min=%.6g W max=%.6g W\n", avg, acc.p_min, acc.p_max);
+    if (wh > 0 && avg > 0)
+        printf("runtime=%.6g h on %.6g Wh at %g%% efficiency (profile repeated)\n",
+               wh * efficiency / 100 / avg, wh, efficiency);
+    return 0;
+}
@@ -0,0 +1,36 @@
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <stdio.h>
+
+// Energy and battery runtime of a load profile
+// Power samples P(t) are integrated with the trapezoid rule as they
+// stream in, so profiles of any length run in constant memory.
+//
+// "main.out energy <profile.csv | -> [--capacity 2000m --vbat 3.7 | --wh 7.4]
+//  [--efficiency 90]"
+// The profile has t,P or t,V,I columns (seconds, watts, volts, amps) with
+// ascending times; a non-numeric first line is a header.
+
+typedef struct {
+    double energy;             // joules so far
+    double t_first, t_last, p_last;
+    double p_min, p_max;
+    long   samples;
+} energy_acc;
+
+void energy_init(energy_acc *a);
+
+// Adds n samples in time order, returns -1 (and adds nothing) if a time
+// is before the previous one
+int energy_add(energy_acc *a, const double t[], const double P[], int n);
+
+// Average power over the profile, 0 with fewer than two samples
+double energy_avg_power(const energy_acc *a);
+
+// Streams a profile from fp, returns 0 or -1 with a message on stderr
+int energy_read(FILE *fp, energy_acc *a);
+
+int energy_main(int argc, char *argv[]);
+
+#endif
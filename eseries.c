@@ -0,0 +1,125 @@
+// IEC 60063 preferred values
+// E24 and below keep their historical two-digit values, which are not the
+// rounded geometric series (2.7, 3.3, 4.7 ...). E192 is round(10^(i/192))
+// to three digits except 9.20, which the standard lists instead of 9.19;
+// E96 and E48 are every 2nd and 4th of its values.
+
+#include <stdlib.h>
+#include <string.h>
+#include "funcs.h"
+#include "eseries.h"
+
+static const short e24[24] = {
+    100, 110, 120, 130, 150, 160, 180, 200, 220, 240, 270, 300,
+    330, 360, 390, 430, 470, 510, 560, 620, 680, 750, 820, 910
+};
+
+// E96, shared with the EIA-96 code (code n is entry n - 1)
+const short e96_values[96] = {
+    100, 102, 105, 107, 110, 113, 115, 118, 121, 124, 127, 130,
+    133, 137, 140, 143, 147, 150, 154, 158, 162, 165, 169, 174,
+    178, 182, 187, 191, 196, 200, 205, 210, 215, 221, 226, 232,
+    237, 243, 249, 255, 261, 267, 274, 280, 287, 294, 301, 309,
+    316, 324, 332, 340, 348, 357, 365, 374, 383, 392, 402, 412,
+    422, 432, 442, 453, 464, 475, 487, 499, 511, 523, 536, 549,
+    562, 576, 590, 604, 619, 634, 649, 665, 681, 698, 715, 732,
+    750, 768, 787, 806, 825, 845, 866, 887, 909, 931, 953, 976,
+};
+
+// E192 adds these between consecutive E96 values
+static const short e192_odd[96] = {
+    101, 104, 106, 109, 111, 114, 117, 120, 123, 126, 129, 132,
+    135, 138, 142, 145, 149, 152, 156, 160, 164, 167, 172, 176,
+    180, 184, 189, 193, 198, 203, 208, 213, 218, 223, 229, 234,
+    240, 246, 252, 258, 264, 271, 277, 284, 291, 298, 305, 312,
+    320, 328, 336, 344, 352, 361, 370, 379, 388, 397, 407, 417,
+    427, 437, 448, 459, 470, 481, 493, 505, 517, 530, 542, 556,
+    569, 583, 597, 612, 626, 642, 657, 673, 690, 706, 723, 741,
+    759, 777, 796, 816, 835, 856, 876, 898, 920, 942, 965, 988,
+};
+
+// m * 10^e for e in -3..9, dividing for negative e so 4.7 is 470 / 100
+#define SCALE(m, e) ((e) >= 0 ? (m) * POW10(e) : (m) / POW10(-(e)))
+
+int eseries_parse(const char *name)
+{
+    char *end;
+    long n;
+
+    if (*name == 'E' || *name == 'e') name++;
+    n = strtol(name, &end, 10);
+    if (end == name || *end) return -1;
+    return eseries_mantissas((int)n, NULL);
+}
+
+int eseries_mantissas(int n, short out[ESERIES_MAX])
+{
+    int i;
+
+    switch (n) {
+    case 3: case 6: case 12: case 24:
+        for (i = 0; out && i < n; i++) out[i] = e24[i * (24 / n)];
+        return n;
+    case 48: case 96:
+        for (i = 0; out && i < n; i++) out[i] = e96_values[i * (96 / n)];
+        return n;
+    case 192:
+        for (i = 0; out && i < n; i++) out[i] = (i & 1) ? e192_odd[i / 2] : e96_values[i / 2];
+        return n;
+    }
+    return -1;
+}
+
+int eseries_range(int n, double lo, double hi, double out[], int max)
+{
+    short m[ESERIES_MAX];
+    int d, i, count = 0;
+
+    if (eseries_mantissas(n, m) < 0 || !(lo > 0) || hi < lo) return 0;
+    if (lo < 1e-1) lo = 1e-1;              // decades 10^-1 .. 10^12
+    if (hi > 9.88e11) hi = 9.88e11;
+
+    for (d = decimal_exponent(lo); d <= decimal_exponent(hi); d++)
+        for (i = 0; i < n; i++) {
+            double v = SCALE((double)m[i], d - 2);
+            if (v > hi || count == max) return count;
+            if (v >= lo) out[count++] = v;
+        }
+    return count;
+}
+
+double eseries_nearest(int n, double R)
+{
+    short m[ESERIES_MAX];
+    int d, i;
+    double x, upper;
+
+    if (eseries_mantissas(n, m) < 0 || !(R > 0 && R <= 9.88e11)) return -1;
+    if (R < 1e-1) return 1e-1;   // below the range: its first value
+
+    d = decimal_exponent(R);
+    x = (d >= 2) ? R / POW10(d - 2) : R * POW10(2 - d);    // 100 <= x < 1000
+    for (i = 0; i + 1 < n && m[i + 1] <= x; i++) ;
+
+    // geometric midpoint; past the last mantissa comes 100 of the next decade
+    upper = (i + 1 < n) ? m[i + 1] : 1000;
+    return SCALE(x * x > m[i] * upper ? upper : (double)m[i], d - 2);
+}
+
+double eseries_ceil(int n, double R)
+{
+    short m[ESERIES_MAX];
+    int d, i;
+    double x;
+
+    if (eseries_mantissas(n, m) < 0 || !(R > 0 && R <= 9.88e11)) return -1;
+    if (R < 1e-1) return 1e-1;   // below the range: its first value
+
+    d = decimal_exponent(R);
+    x = ((d >= 2) ? R / POW10(d - 2) : R * POW10(2 - d)) * (1 - 1e-6);
+    for (i = 0; i < n && m[i] < x; i++) ;
+    if (i < n) return SCALE((double)m[i], d - 2);
+    // past the last mantissa comes 100 of the next decade, unless that
+    // leaves the range (10^12)
+    return (d - 1 < 10) ? SCALE(100.0, d - 1) : -1;
+}
@@ -0,0 +1,30 @@
+#ifndef ESERIES_H
+#define ESERIES_H
+
+// IEC 60063 preferred values (E3 .. E192)
+// Series are named by their count per decade; mantissas are three digits
+// (100 .. 988), so a value is mantissa * 10^(decade - 2).
+
+#define ESERIES_MAX 192
+
+// E96 mantissas 100..976, also the EIA-96 code table (code n is entry n - 1)
+extern const short e96_values[96];
+
+// Series count of a name ("E24", "e96" or "24"), -1 if it is not a series
+int eseries_parse(const char *name);
+
+// Mantissas of series n in ascending order, returns n (or -1)
+int eseries_mantissas(int n, short out[ESERIES_MAX]);
+
+// Values of series n in [lo, hi] in ascending order, at most max of them
+// Returns the count stored
+int eseries_range(int n, double lo, double hi, double out[], int max);
+
+// Value of series n closest to R on a log scale, -1 if R <= 0 or n is invalid
+double eseries_nearest(int n, double R);
+
+// Smallest value of series n that is >= R (to within 1 ppm), 0.1 for any
+// R below it; -1 as above or past the top of the range
+double eseries_ceil(int n, double R);
+
+#endif
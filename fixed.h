@@ -0,0 +1,72 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <stdint.h>
+
+// Fixed-point (integer only) kernels for targets without an FPU
+// Values are Q47.16 in an int64_t: 16 fractional bits, so 1 LSB is about
+// 15 µ-units and the range is about ±1.4e14. Nothing in fixed.c uses
+// float, double or libm; exp and sin come from tables.
+//
+// Building with -DTOOLBOX_FIXED ("make fixed") routes decode_resistor,
+// calc_series, calc_parallel, rc_charge, rc_discharge, solve_ohm and
+// sine_batch in funcs.c through these kernels.
+
+typedef int64_t fx_t;
+
+#define FX_FRAC 16
+#define FX_ONE  ((fx_t)1 << FX_FRAC)
+
+#define FX_FROM_INT(n) ((fx_t)(n) * FX_ONE)
+
+// Results that overflow saturate to +-FX_MAX
+#define FX_MAX INT64_MAX
+#define FX_SATURATED(q) ((q) == FX_MAX || (q) == -FX_MAX)
+
+// Host-side conversions (only used at the edges, not in the kernels).
+// FX_FITS is false for NaN and for magnitudes of FX_RANGE (2^47, about
+// 1.4e14) and up; FX_FROM_DOUBLE gives 0 for those, so check first.
+#define FX_RANGE          140737488355328.0
+#define FX_FITS(x)        ((x) > -FX_RANGE && (x) < FX_RANGE)
+#define FX_FROM_DOUBLE(x) fx_from_double(x)
+#define FX_TO_DOUBLE(q)   ((double)(q) / FX_ONE)
+
+static inline fx_t fx_from_double(double x)
+{
+    return FX_FITS(x) ? (fx_t)(x * FX_ONE + (x >= 0 ? 0.5 : -0.5)) : 0;
+}
+
+fx_t fx_mul(fx_t a, fx_t b);
+fx_t fx_div(fx_t a, fx_t b);            // 0 if b == 0
+fx_t fx_muldiv(fx_t a, fx_t b, fx_t c); // a * b / c with a 128-bit product
+fx_t fx_sqrt(fx_t a);                   // 0 if a <= 0
+fx_t fx_exp_neg(fx_t x);                // e^-x for x >= 0
+
+//  Resistor Color Code
+// Ohms of a 3/4-band code, -1 if a color is invalid
+fx_t fx_decode_resistor(const char *band1, const char *band2,
+                        const char *multiplier, const char *tolerance);
+
+//  Series / Parallel Calculator
+fx_t fx_series(const fx_t r[], int count);
+fx_t fx_parallel(const fx_t r[], int count);   // 0 if empty or any 0 Ω
+
+//  Ohm's Law & Power
+int  fx_solve_ohm(fx_t *V, fx_t *I, fx_t *R, fx_t *P); // unknowns = 0
+
+// RC Charging / Discharging
+// Capacitance in nF and time in µs keep R*C inside the Q16 range
+fx_t fx_rc_charge(fx_t R, fx_t C_nF, fx_t V0, fx_t t_us);
+fx_t fx_rc_discharge(fx_t R, fx_t C_nF, fx_t V0, fx_t t_us);
+
+//  Signal Generator (direct digital synthesis)
+// A 32-bit phase accumulator advanced by f/fs * 2^32 per sample
+typedef struct {
+    uint32_t phase, step;
+    fx_t     amp;
+} fx_dds;
+
+void fx_dds_init(fx_dds *d, fx_t amp, fx_t f, fx_t fs, uint32_t first);
+fx_t fx_dds_next(fx_dds *d);
+
+#endif
@@ -1,14 +1,27 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <math.h>
+#include <stdint.h>
 #include "funcs.h"
+#include "menu.h"
+#include "workspace.h"
+#include "arena.h"
+#include "fixed.h"
+#include "marking.h"
+#include "eseries.h"
+#include "calclog.h"
+#include "logrec.h"
 
 // Basic defines and helper functions for input/output 
 #define PI 3.14159265358979323846
 
+// Input limits (buffers come from the request arena, not the stack)
+#define SP_MAX_RESISTORS  1000
+#define SIG_MAX_SAMPLES   100000
+
 // File used to save calculation history 
-static const char *LOG_FILENAME = "calc_log.txt";
 
 // Reads an integer in range [min, max] with validation 
 // Keeps asking user until correct number is entered 
@@ -54,6 +67,7 @@ static int read_int(const char *prompt, int min, int max)
 
 // Reads a positive floating-point number 
 // Used for voltages, resistance, frequency, etc. 
+// "$name" uses a value saved in the workspace by an earlier calculation
 static double read_positive_double(const char *prompt)
 {
     char buf[64], *endptr;
@@ -67,6 +81,20 @@ static double read_positive_double(const char *prompt)
             exit(1);
         }
 
+        if (buf[0] == '$') {
+            buf[strcspn(buf, " \t\r\n")] = '\0';
+            if (ws_get_value(buf + 1, &val) != 0) {
+                printf("No workspace value named \"%s\".\n", buf + 1);
+                continue;
+            }
+            printf("Using %s = %.6g\n", buf, val);
+            if (val <= 0.0) {
+                printf("Value must be > 0.\n");
+                continue;
+            }
+            return val;
+        }
+
         val = strtod(buf, &endptr);
 
         // Check numeric input
@@ -107,25 +135,29 @@ static void print_resistance_value(double R)
     printf("Approx resistance: %.4g %s\n", disp, unit);
 }
 
-// Ask if user wants to save the result into a text file 
-// Helps keep history of calculations 
-static void ask_and_save(const char *summary)
+// Keep a result in the workspace so later modules can use it as $name
+static void keep_result(const char *name, double value)
+{
+    if (ws_set_value(name, value) == 0) printf("(workspace: $%s)\n", name);
+}
+
+// Ask if user wants to save the result into the log file
+// Helps keep history of calculations
+static void ask_and_save(const logrec *rec)
 {
+    unsigned char data[LOGREC_MAX_SIZE];
     char buf[16];
-    FILE *fp;
 
     printf("\nSave this result to \"%s\"? (y/n): ", LOG_FILENAME);
 
     if (!fgets(buf, sizeof(buf), stdin)) return;
 
     if (buf[0] == 'y' || buf[0] == 'Y') {
-        fp = fopen(LOG_FILENAME, "a");
-        if (!fp) {
-            printf("Could not open log file.\n");
+        // one framed record per result, safe with other instances writing
+        if (clog_append(LOG_FILENAME, data, logrec_encode(rec, data)) != 0) {
+            printf("Could not write log file.\n");
             return;
         }
-        fprintf(fp, "%s\n", summary);
-        fclose(fp);
         printf("Saved.\n");
     } else {
         printf("Not saved.\n");
@@ -147,11 +179,6 @@ static const char *multiplier_color_names[] = {
     "8 Grey x100M", "9 White x1G", "10 Gold x0.1", "11 Silver x0.01"
 };
 
-// Actual multiplier values
-static const double multiplier_values[] = {
-    1.0, 10.0, 100.0, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 0.1, 0.01
-};
-
 // Tolerance band (Band 4)
 static const char *tolerance_color_names[] = {
     "0 Brown ±1%", "1 Red ±2%", "2 Green ±0.5%", "3 Blue ±0.25%",
@@ -163,6 +190,11 @@ static const char *tolerance_values_str[] = {
     "±1%", "±2%", "±0.5%", "±0.25%", "±0.1%", "±0.05%", "±5%", "±10%"
 };
 
+// Same in percent, for the log record
+static const double tolerance_values_pct[] = {
+    1.0, 2.0, 0.5, 0.25, 0.1, 0.05, 5.0, 10.0
+};
+
 // Print reference tables for user
 static void print_digit_table(void)
 {
@@ -187,7 +219,7 @@ static void rcc_color_to_resistance(void)
 {
     int b1, b2, m, t;
     double base, R;
-    char summary[256];
+    logrec rec;
 
     printf("\n=== Color → Resistance (4-band) ===\n");
 
@@ -204,7 +236,7 @@ static void rcc_color_to_resistance(void)
 
     // Compute resistance
     base = b1 * 10 + b2;
-    R = base * multiplier_values[m];
+    R = base * marking_multiplier(&mk_resistor, m);
 
     printf("\n--- Result ---\n");
     printf("Bands: %s | %s | %s | %s\n",
@@ -213,37 +245,32 @@ static void rcc_color_to_resistance(void)
 
     print_resistance_value(R);
     printf("Tolerance: %s\n", tolerance_values_str[t]);
+    keep_result("rcc_r", R);
 
-    // Prepare saved text
-    snprintf(summary, sizeof(summary),
-             "[Color→Resistance] (%d,%d,m=%d,t=%d) = %.6g Ω, tol %s",
-             b1, b2, m, t, R, tolerance_values_str[t]);
-    ask_and_save(summary);
+    // Prepare saved record
+    logrec_init(&rec, LR_COLOR_TO_R);
+    rec.f[0] = b1; rec.f[1] = b2; rec.f[2] = m; rec.f[3] = t;
+    rec.f[4] = R;  rec.f[5] = tolerance_values_pct[t];
+    ask_and_save(&rec);
 }
 
 // Convert numeric resistance to approximate 4-band colors 
 // Uses rounding to pick 2 significant digits 
 static void rcc_resistance_to_color(void)
 {
-    double R, base;
-    int d1, d2, m = 0, rounded;
-    char summary[256];
+    double R;
+    int d1, d2, m;
+    logrec rec;
 
     printf("\n=== Resistance → Color (approx) ===\n");
     printf("Uses two significant digits.\n");
 
     R = read_positive_double("Enter resistance (Ω): ");
 
-    // Normalize into 2 digits
-    base = R;
-    while (base >= 100 && m < 9) { base /= 10; m++; }
-    while (base < 10 && m > 0) { base *= 10; m--; }
-
-    rounded = (int)(base + 0.5);
-    if (rounded >= 100) { rounded = 10; m++; }
-
-    d1 = rounded / 10;
-    d2 = rounded % 10;
+    if (encode_resistor(R, &d1, &d2, &m) != 0) {
+        printf("Resistance is outside the color code range.\n");
+        return;
+    }
 
     // Display
     printf("\n--- Suggested Colors ---\n");
@@ -253,10 +280,9 @@ static void rcc_resistance_to_color(void)
     printf("Band 3: %s\n", multiplier_color_names[m]);
     printf("Band 4: (choose based on component tolerance)\n");
 
-    snprintf(summary, sizeof(summary),
-             "[Resistance→Color] R=%.6g → (%d,%d,m=%d)",
-             R, d1, d2, m);
-    ask_and_save(summary);
+    logrec_init(&rec, LR_R_TO_COLOR);
+    rec.f[0] = R; rec.f[1] = d1; rec.f[2] = d2; rec.f[3] = m;
+    ask_and_save(&rec);
 }
 
 // Print all tables at once (for quick reference)
@@ -269,41 +295,82 @@ static void rcc_print_tables(void)
     printf("\n4-band meaning:\n  Band 1: 1st digit\n  Band 2: 2nd digit\n  Band 3: multiplier\n  Band 4: tolerance\n");
 }
 
-// Submenu for Resistor Color Code tool //
-static void module_resistor_color_code(void)
+// Decode a capacitor, inductor or SMD marking through marking.c
+static void rcc_decode_marking(void)
 {
-    int c;
-    do {
-        printf("\n== Resistor Color Code Tool ==\n");
-        printf("1. Color → Resistance\n");
-        printf("2. Resistance → Color\n");
-        printf("3. Show Tables\n");
-        printf("0. Back\n");
+    static const marking_family *const fams[] = { &mk_resistor, &mk_inductor, &mk_capacitor, &mk_eia96 };
+    const marking_family *f;
+    marking_result r;
+    char buf[128];
+    logrec rec;
+    int i, fam;
+
+    printf("\n=== Decode Marking ===\n");
+    for (i = 0; i < 4; i++) printf("%d. %-10s e.g. \"%s\"\n", i + 1, fams[i]->name, fams[i]->example);
+    fam = read_int("Select code family (1–4): ", 1, 4) - 1;
+    f = fams[fam];
+
+    printf("Enter marking: ");
+    if (!fgets(buf, sizeof(buf), stdin)) return;
+    buf[strcspn(buf, "\r\n")] = '\0';
 
-        c = read_int("Select: ", 0, 3);
+    if (marking_decode(f, buf, &r) != 0) {
+        printf("'%s' is not a valid %s marking.\n", buf, f->name);
+        return;
+    }
 
-        if (c == 1) rcc_color_to_resistance();
-        else if (c == 2) rcc_resistance_to_color();
-        else if (c == 3) rcc_print_tables();
-    } while (c != 0);
+    printf("\n--- Result ---\n");
+    printf("Value: %.6g %s\n", r.value, f->unit);
+    if (r.tol_minus_pct != r.tol_pct) printf("Tolerance: +%g/-%g%%\n", r.tol_pct, r.tol_minus_pct);
+    else if (r.tol_pct > 0) printf("Tolerance: ±%g%%\n", r.tol_pct);
+    if (r.tol_abs > 0) printf("Tolerance: ±%g %s\n", r.tol_abs, f->unit);
+    if (r.tempco_ppm > 0) printf("Tempco: %g ppm/K\n", r.tempco_ppm);
+    keep_result("mk_value", r.value);
+
+    logrec_init(&rec, LR_MARKING);
+    rec.f[0] = fam;
+    rec.f[1] = r.value; rec.f[2] = r.tol_pct; rec.f[3] = r.tol_abs;
+    rec.f[4] = r.tol_minus_pct;
+    ask_and_save(&rec);
 }
 
+// Submenu for Resistor Color Code tool //
+static const menu_entry_t rcc_entries[] = {
+    { 1, "Color → Resistance", "color-to-r", rcc_color_to_resistance, NULL },
+    { 2, "Resistance → Color", "r-to-color", rcc_resistance_to_color, NULL },
+    { 3, "Show Tables",        "tables",     rcc_print_tables,        NULL },
+    { 4, "Decode Marking",     "marking-decode", rcc_decode_marking,  NULL },
+    { 0, "Back",               NULL,         NULL,                    NULL },
+};
+
+static menu_t rcc_menu = {
+    .header  = "\n== Resistor Color Code Tool ==\n",
+    .prompt  = "Select: ",
+    .entries = rcc_entries,
+    .count   = sizeof(rcc_entries) / sizeof(rcc_entries[0]),
+};
+
 // Module 2: Series / Parallel Tool
 // Calculates equivalent resistance for N resistors
 static void module_series_parallel_resistors(void)
 {
     int n, i, mode;
-    double R[10], total = 0.0;
-    char summary[256];
+    size_t rows[2];
+    double *R, total = 0.0;
+    char prompt[64];
+    logrec rec;
 
     printf("\n==== Series / Parallel Resistors ====\n");
     
     // User selects number of resistors
-    n = read_int("Number of resistors (1–10): ", 1, 10);
+    snprintf(prompt, sizeof(prompt), "Number of resistors (1–%d): ", SP_MAX_RESISTORS);
+    n = read_int(prompt, 1, SP_MAX_RESISTORS);
+
+    R = arena_alloc(&request_arena, sizeof(double) * n);
+    if (!R) { printf("Out of memory.\n"); return; }
 
     // Read each resistor value
     for (i = 0; i < n; i++) {
-        char prompt[64];
         snprintf(prompt, sizeof(prompt),
                  "Enter R%d (Ω): ", i + 1);
         R[i] = read_positive_double(prompt);
@@ -314,27 +381,27 @@ static void module_series_parallel_resistors(void)
     printf("2. Parallel\n");
     mode = read_int("Select: ", 1, 2);
 
-    // Compute result
+    // Compute result as a one-row batch
+    rows[0] = 0;
+    rows[1] = n;
     if (mode == 1) {
         // Series: sum up all
-        for (i = 0; i < n; i++) total += R[i];
+        series_rows(R, rows, 1, &total);
         printf("\n--- Series Result ---\n");
     } else {
         // Parallel: 1 / (sum of inverses)
-        double inv_sum = 0.0;
-        for (i = 0; i < n; i++) inv_sum += 1.0 / R[i];
-        if (inv_sum == 0.0) { printf("Math error.\n"); return; }
-        total = 1.0 / inv_sum;
+        parallel_rows(R, rows, 1, &total);
+        if (total == 0.0) { printf("Math error.\n"); return; }
         printf("\n--- Parallel Result ---\n");
     }
 
     print_resistance_value(total);
+    keep_result("sp_total", total);
 
     // Save if user wants
-    snprintf(summary, sizeof(summary),
-             "Series/Parallel: n=%d, mode=%s → %.6g Ω",
-             n, (mode == 1 ? "series" : "parallel"), total);
-    ask_and_save(summary);
+    logrec_init(&rec, LR_SERIES_PARALLEL);
+    rec.f[0] = n; rec.f[1] = mode; rec.f[2] = total;
+    ask_and_save(&rec);
 }
 
 // Module 3: RC Charging and Discharging Tool
@@ -343,7 +410,7 @@ static void module_rc_charge_discharge(void)
 {
     double R, C, tau, t, V, V0, Vc;
     int mode;
-    char summary[256];
+    logrec rec;
 
     printf("\n==== RC Charging/Discharging ====\n");
     printf("Use SI units: R(Ω), C(F), t(s)\n\n");
@@ -354,6 +421,7 @@ static void module_rc_charge_discharge(void)
     tau = R * C;  // Time constant
 
     printf("\nTime constant τ = %.6g s\n", tau);
+    keep_result("rc_tau", tau);
 
     // Choose mode
     printf("\nCalculation mode:\n");
@@ -369,20 +437,21 @@ static void module_rc_charge_discharge(void)
         Vc = V * (1.0 - exp(-t / tau));
         printf("\n--- Charging Result ---\n");
         printf("Vc(t = %.6g s) = %.6g V\n", t, Vc);
-        snprintf(summary, sizeof(summary),
-                 "RC charge: R=%.6g, C=%.6g, V=%.6g, t=%.6g → %.6g V",
-                 R, C, V, t, Vc);
+        keep_result("rc_vc", Vc);
+        logrec_init(&rec, LR_RC_CHARGE);
+        rec.f[2] = V;
     } else {
         V0 = read_positive_double("Enter initial voltage V0 (V): ");
         Vc = V0 * exp(-t / tau);
         printf("\n--- Discharging Result ---\n");
         printf("Vc(t = %.6g s) = %.6g V\n", t, Vc);
-        snprintf(summary, sizeof(summary),
-                 "RC discharge: R=%.6g, C=%.6g, V0=%.6g, t=%.6g → %.6g V",
-                 R, C, V0, t, Vc);
+        keep_result("rc_vc", Vc);
+        logrec_init(&rec, LR_RC_DISCHARGE);
+        rec.f[2] = V0;
     }
 
-    ask_and_save(summary);
+    rec.f[0] = R; rec.f[1] = C; rec.f[3] = t; rec.f[4] = Vc;
+    ask_and_save(&rec);
 }
 
 
@@ -393,7 +462,7 @@ static void module_ohm_and_power(void)
 {
     int choice;
     double V=0, I=0, R=0, P=0;
-    char summary[256];
+    logrec rec;
 
     printf("\n==== Ohm’s Law / Power ====\n");
     printf("Choose known quantities:\n");
@@ -435,151 +504,745 @@ static void module_ohm_and_power(void)
     printf("Current  I = %.6g A\n", I);
     printf("Resistance R = %.6g Ω\n", R);
     printf("Power     P = %.6g W\n", P);
-
-    snprintf(summary, sizeof(summary),
-             "Ohm/Power: V=%.6g, I=%.6g, R=%.6g, P=%.6g",
-             V, I, R, P);
-    ask_and_save(summary);
+    keep_result("ohm_v", V);
+    keep_result("ohm_i", I);
+    keep_result("ohm_r", R);
+    keep_result("ohm_p", P);
+
+    logrec_init(&rec, LR_OHM);
+    rec.f[0] = V; rec.f[1] = I; rec.f[2] = R; rec.f[3] = P;
+    ask_and_save(&rec);
 }
 
 // Module 5: Signal Generation & Analysis
 // Provides basic signal info and sample generation
-static void module_signal_generation(void)
+
+// Compute period and angular frequency
+static void sig_period_and_omega(void)
 {
-    int choice;
+    double f, T, w;
+    logrec rec;
 
-    printf("\n==== Signal Generation / Analysis ====\n");
-
-    do {
-        printf("\n1. Given f → T & ω\n");
-        printf("2. Generate sine samples\n");
-        printf("0. Back\n");
-
-        choice = read_int("Select: ", 0, 2);
-
-        if (choice == 1) {
-            // Compute period and angular frequency
-            double f, T, w;
-            char summary[256];
-
-            f = read_positive_double("Enter f (Hz): ");
-            T = 1.0 / f;         // Period
-            w = 2 * PI * f;      // Angular frequency
-
-            printf("\n--- Result ---\n");
-            printf("Period T = %.6g s\n", T);
-            printf("Angular freq ω = %.6g rad/s\n", w);
-
-            snprintf(summary, sizeof(summary),
-                     "Signal: f=%.6g Hz, T=%.6g s, ω=%.6g rad/s",
-                     f, T, w);
-            ask_and_save(summary);
-
-        } else if (choice == 2) {
-            // Generate discrete sine wave samples
-            double f, A, fs;
-            int N, n;
-            char summary[256];
-
-            printf("\nSignal: x(t) = A sin(2πft)\n");
-            f  = read_positive_double("Frequency f (Hz): ");
-            A  = read_positive_double("Amplitude A: ");
-            fs = read_positive_double("Sampling freq fs (Hz): ");
-            N  = read_int("Number of samples (1–100): ", 1, 100);
-
-            printf("\nn\t t(s)\t\t x[n]\n");
-            for (n = 0; n < N; n++) {
-                double t = n / fs;
-                double x = A * sin(2 * PI * f * t);
-                printf("%d\t %.6g\t %.6g\n", n, t, x);
-            }
+    f = read_positive_double("Enter f (Hz): ");
+    T = 1.0 / f;         // Period
+    w = 2 * PI * f;      // Angular frequency
 
-            snprintf(summary, sizeof(summary),
-                     "Sine: f=%.6g Hz, A=%.6g, fs=%.6g Hz, N=%d",
-                     f, A, fs, N);
-            ask_and_save(summary);
-        }
+    printf("\n--- Result ---\n");
+    printf("Period T = %.6g s\n", T);
+    printf("Angular freq ω = %.6g rad/s\n", w);
+    keep_result("sig_t", T);
+    keep_result("sig_w", w);
+
+    logrec_init(&rec, LR_SIGNAL);
+    rec.f[0] = f; rec.f[1] = T; rec.f[2] = w;
+    ask_and_save(&rec);
+}
+
+// Generate discrete sine wave samples
+static void sig_sine_samples(void)
+{
+    double f, A, fs, *samples;
+    int N, n;
+    char prompt[64];
+    logrec rec;
+
+    printf("\nSignal: x(t) = A sin(2πft)\n");
+    f  = read_positive_double("Frequency f (Hz): ");
+    A  = read_positive_double("Amplitude A: ");
+    fs = read_positive_double("Sampling freq fs (Hz): ");
+    snprintf(prompt, sizeof(prompt), "Number of samples (1–%d): ", SIG_MAX_SAMPLES);
+    N  = read_int(prompt, 1, SIG_MAX_SAMPLES);
+
+    // samples are also kept in the workspace as the array $sine
+    samples = ws_alloc_array("sine", N);
+
+    printf("\nn\t t(s)\t\t x[n]\n");
+    for (n = 0; n < N; n++) {
+        double t = n / fs;
+        double x = A * sin(2 * PI * f * t);
+        printf("%d\t %.6g\t %.6g\n", n, t, x);
+        if (samples) samples[n] = x;
+    }
+    if (samples) printf("(workspace: $sine, %d values)\n", N);
 
-    } while (choice != 0);
+    logrec_init(&rec, LR_SINE);
+    rec.f[0] = f; rec.f[1] = A; rec.f[2] = fs; rec.f[3] = N;
+    ask_and_save(&rec);
 }
 
+static const menu_entry_t signal_entries[] = {
+    { 1, "Given f → T & ω",        "sig-period", sig_period_and_omega, NULL },
+    { 2, "Generate sine samples", "sig-sine",   sig_sine_samples,     NULL },
+    { 0, "Back",                  NULL,         NULL,                 NULL },
+};
+
+static menu_t signal_menu = {
+    .header  = "\n==== Signal Generation / Analysis ====\n\n",
+    .prompt  = "Select: ",
+    .entries = signal_entries,
+    .count   = sizeof(signal_entries) / sizeof(signal_entries[0]),
+};
+
 // Module 6: File / Log Operations
 // Allows user to view saved calculations or clear them
-static void module_file_save_and_log(void)
+
+static int log_print_record(const void *data, size_t len, void *ctx)
 {
-    int choice;
-    FILE *fp;
-
-    do {
-        printf("\n==== File & Log Tools ====\n");
-        printf("Current log file: \"%s\"\n", LOG_FILENAME);
-        printf("1. View file\n");
-        printf("2. Clear file\n");
-        printf("0. Back\n");
-
-        choice = read_int("Select: ", 0, 2);
-
-        if (choice == 1) {
-            // Open and print stored results
-            char line[256];
-            fp = fopen(LOG_FILENAME, "r");
-            if (!fp) {
-                printf("No file or cannot open (maybe empty).\n");
-            } else {
-                printf("\n--- File Start ---\n");
-                while (fgets(line, sizeof(line), fp)) fputs(line, stdout);
-                printf("--- File End ---\n");
-                fclose(fp);
-            }
+    char line[LOGREC_TEXT_MAX];
+
+    (void)ctx;
+    logrec_format(data, len, line, sizeof(line));
+    puts(line);
+    return 0;
+}
+
+// Open and print stored results
+static void log_view(void)
+{
+    clog_stats st;
+
+    printf("\n--- File Start ---\n");
+    if (clog_scan(LOG_FILENAME, log_print_record, NULL, &st) != 0)
+        printf("Cannot open the log file.\n");
+    else if (st.records == 0 && st.torn == 0)
+        printf("(empty)\n");
+    printf("--- File End ---\n");
+    if (st.torn) printf("(%ld damaged record(s) skipped)\n", st.torn);
+}
+
+// Clear log file (waits for saves in progress in other instances)
+static void log_clear(void)
+{
+    if (clog_clear(LOG_FILENAME) != 0) printf("Failed to clear file.\n");
+    else printf("File cleared.\n");
+}
+
+static const menu_entry_t log_entries[] = {
+    { 1, "View file",  "log-view",  log_view,  NULL },
+    { 2, "Clear file", "log-clear", log_clear, NULL },
+    { 0, "Back",       NULL,        NULL,      NULL },
+};
+
+static menu_t log_menu = {
+    .header  = "\n==== File & Log Tools ====\n"
+               "Current log file: \"" LOG_FILENAME "\"\n",
+    .prompt  = "Select: ",
+    .entries = log_entries,
+    .count   = sizeof(log_entries) / sizeof(log_entries[0]),
+};
+
+// Module 7: Workspace
+// Values kept by the other modules, reusable as $name at any prompt
+static void ws_show(void)
+{
+    printf("\n--- Workspace ---\n");
+    ws_list(stdout);
+    printf("--- End ---\n");
+}
+
+static void ws_reset(void)
+{
+    ws_clear();
+    printf("Workspace cleared.\n");
+}
+
+static const menu_entry_t ws_entries[] = {
+    { 1, "List values", "ws-list",  ws_show,  NULL },
+    { 2, "Clear",       "ws-clear", ws_reset, NULL },
+    { 0, "Back",        NULL,       NULL,     NULL },
+};
+
+static menu_t ws_menu = {
+    .header  = "\n==== Workspace ====\n"
+               "Saved results can be typed as $name at any number prompt\n",
+    .prompt  = "Select: ",
+    .entries = ws_entries,
+    .count   = sizeof(ws_entries) / sizeof(ws_entries[0]),
+};
+
+// Calculation kernels
+// Pure functions with no user I/O, shared by the menus, the command line
+// interface (cli.c) and anything else that needs the raw numbers.
+
+// Color band lookups, all through the resistor family of marking.c
+
+const char *color_name(int index)
+{
+    return marking_color_name(index);
+}
+
+// Digit value 0–9 of a band color, -1 if not a digit color
+int get_digit(const char *color)
+{
+    int i = marking_color(color);
+    return (i >= 0) ? mk_resistor.digit[i] - 1 : -1;
+}
+
+// Multiplier of a band color, -1 if unknown
+float get_multiplier(const char *color)
+{
+    return (float)marking_multiplier(&mk_resistor, marking_color(color));
+}
+
+// Tolerance in percent of a band color, 20% if no band, -1 if unknown
+float get_tolerance(const char *color)
+{
+    int i;
+    if (!color || !*color) return mk_resistor.tol_default / 100.0f;
+    i = marking_color(color);
+    return (i >= 0 && mk_resistor.tol[i] > 0) ? mk_resistor.tol[i] / 100.0f : -1.0f;
+}
+
+#ifdef TOOLBOX_FIXED
+// Fixed-point build: the kernels below run through fixed.c and only the
+// arguments and results are converted
+float decode_resistor(const char *band1, const char *band2,
+                      const char *multiplier, const char *tolerance)
+{
+    fx_t R = fx_decode_resistor(band1, band2, multiplier, tolerance);
+    return (R < 0) ? -1.0f : (float)FX_TO_DOUBLE(R);
+}
+#else
+// 4-band (or 3-band with tolerance NULL) color code to ohms, -1 if invalid
+float decode_resistor(const char *band1, const char *band2,
+                      const char *multiplier, const char *tolerance)
+{
+    unsigned char code[4];
+    marking_result r;
+    int n = (tolerance && *tolerance) ? 4 : 3, i;
+    const char *bands[4] = { band1, band2, multiplier, tolerance };
+
+    for (i = 0; i < n; i++) {
+        int c = marking_color(bands[i]);
+        if (c < 0) return -1.0f;
+        code[i] = (unsigned char)c;
+    }
+    return (marking_decode_codes(&mk_resistor, code, n, &r) == 0) ? (float)r.value : -1.0f;
+}
+#endif
+
+// 10^k for k = -4..13 (see POW10 in funcs.h)
+const double pow10_table[18] = {
+    1e-4, 1e-3, 1e-2, 1e-1, 1e0, 1e1, 1e2, 1e3, 1e4,
+    1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13
+};
+
+// floor(log10 R) for R in [1e-3, 1e12] without a log call: the binary
+// exponent in the IEEE bits times 1233/4096 (~ log10 2) is exact or one
+// low, and one table comparison fixes that
+int decimal_exponent(double R)
+{
+    uint64_t bits;
+    int e2, e10;
+
+    memcpy(&bits, &R, sizeof(bits));
+    e2 = (int)((bits >> 52) & 0x7ff) - 1023;
+    e10 = (e2 * 1233) >> 12;
+    return e10 + (R >= POW10(e10 + 1));
+}
+
+// ndigits significant digits of R and the decimal exponent of the last one
+// (exponent -2..9, the multiplier band range), without normalization loops
+// Returns 0 on success, -1 if R is out of the color code range
+static int encode_sig(double R, int ndigits, int *sig, int *exp10)
+{
+    int m, s, top = (ndigits == 2) ? 100 : 1000;
+
+    if (!(R >= 1e-3 && R <= 1e12)) return -1;
+
+    m = decimal_exponent(R) - (ndigits - 1);
+    if (m < -2) m = -2;                   // silver is the smallest multiplier
+    // scale by an exact power of ten (10^-m is not exact for m > 0)
+    s = (int)((m >= 0 ? R / POW10(m) : R * POW10(-m)) + 0.5);
+    if (s >= top) { s /= 10; m++; }       // 99.6 rounds up to 100
+    if (s == 0 || m > 9) return -1;
+
+    *sig = s;
+    *exp10 = m;
+    return 0;
+}
+
+// Multiplier band index of a decimal exponent (-1 → 10 gold, -2 → 11 silver)
+#define MULT_INDEX(e) ((e) >= 0 ? (e) : 9 - (e))
+
+// Resistance to two significant digits and a multiplier index
+// (gold/silver multipliers are used below 10 Ω)
+// Returns 0 on success, -1 if R is out of the color code range
+int encode_resistor(double R, int *d1, int *d2, int *m)
+{
+    int sig, e;
+
+    if (encode_sig(R, 2, &sig, &e) != 0) return -1;
+    *d1 = sig / 10;
+    *d2 = sig % 10;
+    *m  = MULT_INDEX(e);
+    return 0;
+}
+
+// Color index of a tolerance in percent, -1 if there is no such band
+int tolerance_color(double pct)
+{
+    int i, hundredths = (int)(pct * 100.0 + 0.5);
+    for (i = 0; i < 12; i++)
+        if (mk_resistor.tol[i] == hundredths) return i;
+    return -1;
+}
+
+// Color index of a temperature coefficient, -1 if there is no such band
+int tempco_color(int ppm)
+{
+    int i;
+    for (i = 0; i < 12; i++)
+        if (mk_resistor.tempco[i] && mk_resistor.tempco[i] == ppm) return i;
+    return -1;
+}
+
+// Generic loops, used for counts without an unrolled version
+float calc_series_loop(const float resistors[], int count)
+{
+    float total = 0.0f;
+    int i;
+    for (i = 0; i < count; i++) total += resistors[i];
+    return total;
+}
+
+// Returns 0 if there are no resistors or one of them is 0 Ω
+float calc_parallel_loop(const float resistors[], int count)
+{
+    float inv_sum = 0.0f;
+    int i;
+    for (i = 0; i < count; i++) {
+        if (resistors[i] == 0.0f) return 0.0f;
+        inv_sum += 1.0f / resistors[i];
+    }
+    return (inv_sum == 0.0f) ? 0.0f : 1.0f / inv_sum;
+}
+
+#ifdef TOOLBOX_FIXED
+// Values outside the Q16 range, and results that saturated, come back as
+// NAN instead of a wrong number
+static int fx_from_floats(const float in[], fx_t out[], int count)
+{
+    int i;
+    for (i = 0; i < count; i++) {
+        if (!FX_FITS(in[i])) return -1;
+        out[i] = FX_FROM_DOUBLE(in[i]);
+    }
+    return count;
+}
 
-        } else if (choice == 2) {
-            // Clear log file
-            fp = fopen(LOG_FILENAME, "w");
-            if (!fp) printf("Failed to clear file.\n");
-            else {
-                fclose(fp);
-                printf("File cleared.\n");
+static float fx_to_float(fx_t q)
+{
+    return FX_SATURATED(q) ? NAN : (float)FX_TO_DOUBLE(q);
+}
+
+float calc_series(const float resistors[], int count)
+{
+    fx_t r[SP_MAX_RESISTORS];
+    if (count > SP_MAX_RESISTORS) return calc_series_loop(resistors, count);
+    if (fx_from_floats(resistors, r, count) < 0) return NAN;
+    return fx_to_float(fx_series(r, count));
+}
+
+float calc_parallel(const float resistors[], int count)
+{
+    fx_t r[SP_MAX_RESISTORS];
+    if (count > SP_MAX_RESISTORS) return calc_parallel_loop(resistors, count);
+    if (fx_from_floats(resistors, r, count) < 0) return NAN;
+    return fx_to_float(fx_parallel(r, count));
+}
+
+// C and t are passed on in nF and µs
+float rc_charge(float R, float C, float V0, float t)
+{
+    if (!FX_FITS(R) || !FX_FITS(C * 1e9) || !FX_FITS(V0) || !FX_FITS(t * 1e6)) return NAN;
+    return fx_to_float(fx_rc_charge(FX_FROM_DOUBLE(R), FX_FROM_DOUBLE(C * 1e9),
+                                    FX_FROM_DOUBLE(V0), FX_FROM_DOUBLE(t * 1e6)));
+}
+
+float rc_discharge(float R, float C, float V0, float t)
+{
+    if (!FX_FITS(R) || !FX_FITS(C * 1e9) || !FX_FITS(V0) || !FX_FITS(t * 1e6)) return NAN;
+    return fx_to_float(fx_rc_discharge(FX_FROM_DOUBLE(R), FX_FROM_DOUBLE(C * 1e9),
+                                       FX_FROM_DOUBLE(V0), FX_FROM_DOUBLE(t * 1e6)));
+}
+#else
+// Unrolled versions for 2..16 resistors, generated by the macros below.
+// They add in the same order as the loops so the results are identical.
+// The parallel version has no early exit: a 0 Ω resistor is remembered
+// in a flag and selected at the end.
+#define SP_REP2(M)  M(0) M(1)
+#define SP_REP3(M)  SP_REP2(M) M(2)
+#define SP_REP4(M)  SP_REP3(M) M(3)
+#define SP_REP5(M)  SP_REP4(M) M(4)
+#define SP_REP6(M)  SP_REP5(M) M(5)
+#define SP_REP7(M)  SP_REP6(M) M(6)
+#define SP_REP8(M)  SP_REP7(M) M(7)
+#define SP_REP9(M)  SP_REP8(M) M(8)
+#define SP_REP10(M) SP_REP9(M) M(9)
+#define SP_REP11(M) SP_REP10(M) M(10)
+#define SP_REP12(M) SP_REP11(M) M(11)
+#define SP_REP13(M) SP_REP12(M) M(12)
+#define SP_REP14(M) SP_REP13(M) M(13)
+#define SP_REP15(M) SP_REP14(M) M(14)
+#define SP_REP16(M) SP_REP15(M) M(15)
+
+#define SP_ADD(i) total += r[i];
+#define SP_ADD_INV(i) zero |= (r[i] == 0.0f); inv_sum += 1.0f / r[i];
+
+#define SP_DEFINE(n)                                                \
+    static float series_##n(const float r[])                        \
+    {                                                               \
+        float total = 0.0f;                                         \
+        SP_REP##n(SP_ADD)                                           \
+        return total;                                               \
+    }                                                               \
+    static float parallel_##n(const float r[])                      \
+    {                                                               \
+        float inv_sum = 0.0f;                                       \
+        int zero = 0;                                               \
+        SP_REP##n(SP_ADD_INV)                                       \
+        return (zero | (inv_sum == 0.0f)) ? 0.0f : 1.0f / inv_sum;  \
+    }
+
+SP_DEFINE(2)  SP_DEFINE(3)  SP_DEFINE(4)  SP_DEFINE(5)
+SP_DEFINE(6)  SP_DEFINE(7)  SP_DEFINE(8)  SP_DEFINE(9)
+SP_DEFINE(10) SP_DEFINE(11) SP_DEFINE(12) SP_DEFINE(13)
+SP_DEFINE(14) SP_DEFINE(15) SP_DEFINE(16)
+
+#define SP_UNROLL_MAX 16
+
+typedef float (*sp_fixed_t)(const float r[]);
+
+static const sp_fixed_t series_fixed[SP_UNROLL_MAX + 1] = {
+    NULL, NULL, series_2, series_3, series_4, series_5, series_6, series_7,
+    series_8, series_9, series_10, series_11, series_12, series_13,
+    series_14, series_15, series_16,
+};
+
+static const sp_fixed_t parallel_fixed[SP_UNROLL_MAX + 1] = {
+    NULL, NULL, parallel_2, parallel_3, parallel_4, parallel_5, parallel_6,
+    parallel_7, parallel_8, parallel_9, parallel_10, parallel_11,
+    parallel_12, parallel_13, parallel_14, parallel_15, parallel_16,
+};
+
+float calc_series(const float resistors[], int count)
+{
+    if (count >= 2 && count <= SP_UNROLL_MAX) return series_fixed[count](resistors);
+    return calc_series_loop(resistors, count);
+}
+
+// Returns 0 if there are no resistors or one of them is 0 Ω
+float calc_parallel(const float resistors[], int count)
+{
+    if (count >= 2 && count <= SP_UNROLL_MAX) return parallel_fixed[count](resistors);
+    return calc_parallel_loop(resistors, count);
+}
+
+// Vc(t) = V0 (1 - e^(-t/RC))
+float rc_charge(float R, float C, float V0, float t)
+{
+    return V0 * (1.0f - expf(-t / (R * C)));
+}
+
+// Vc(t) = V0 e^(-t/RC)
+float rc_discharge(float R, float C, float V0, float t)
+{
+    return V0 * expf(-t / (R * C));
+}
+#endif
+
+float calc_voltage(float I, float R)    { return I * R; }
+float calc_current(float V, float R)    { return V / R; }
+float calc_resistance(float V, float I) { return V / I; }
+float calc_power(float V, float I)      { return V * I; }
+
+#ifdef TOOLBOX_FIXED
+int solve_ohm(double *V, double *I, double *R, double *P)
+{
+    fx_t v = FX_FROM_DOUBLE(*V), i = FX_FROM_DOUBLE(*I);
+    fx_t r = FX_FROM_DOUBLE(*R), p = FX_FROM_DOUBLE(*P);
+
+    if (!FX_FITS(*V) || !FX_FITS(*I) || !FX_FITS(*R) || !FX_FITS(*P)) return -2;
+    if (fx_solve_ohm(&v, &i, &r, &p) != 0) return -1;
+    if (FX_SATURATED(v) || FX_SATURATED(i) || FX_SATURATED(r) || FX_SATURATED(p)) return -2;
+    *V = FX_TO_DOUBLE(v);
+    *I = FX_TO_DOUBLE(i);
+    *R = FX_TO_DOUBLE(r);
+    *P = FX_TO_DOUBLE(p);
+    return 0;
+}
+#else
+// Fills in the unknown two of V, I, R, P (unknowns passed as 0)
+// Returns 0 on success, -1 unless exactly two values are known
+int solve_ohm(double *V, double *I, double *R, double *P)
+{
+    int known = (*V > 0) + (*I > 0) + (*R > 0) + (*P > 0);
+
+    if (known != 2) return -1;
+
+    if (*V > 0 && *R > 0)      { *I = *V / *R; *P = *V * *I; }
+    else if (*V > 0 && *I > 0) { *R = *V / *I; *P = *V * *I; }
+    else if (*V > 0 && *P > 0) { *I = *P / *V; *R = *V / *I; }
+    else if (*I > 0 && *R > 0) { *V = *I * *R; *P = *V * *I; }
+    else if (*I > 0 && *P > 0) { *V = *P / *I; *R = *V / *I; }
+    else                       { *V = sqrt(*P * *R); *I = *V / *R; }
+    return 0;
+}
+#endif
+
+// Parses a number with an optional SI suffix: "4.7k", "1u", "5m", "2M2"
+// The suffix may also stand in for the decimal point ("4k7" = 4700)
+// Returns 0 on success, -1 on bad input
+int parse_si_value(const char *s, double *out)
+{
+    char *end;
+    double val, scale = 1.0;
+
+    if (!s || !*s) return -1;
+
+    val = strtod(s, &end);
+    if (end == s) return -1;
+
+    switch (*end) {
+    case 'p': scale = 1e-12; break;
+    case 'n': scale = 1e-9;  break;
+    case 'u': scale = 1e-6;  break;
+    case 'm': scale = 1e-3;  break;
+    case 'R': case 'r': scale = 1.0; break;
+    case 'k': case 'K': scale = 1e3; break;
+    case 'M': scale = 1e6;   break;
+    case 'G': scale = 1e9;   break;
+    default: break;
+    }
+
+    if (scale != 1.0 || *end == 'R' || *end == 'r') {
+        end++;
+        // "4k7" style: digits after the suffix are the fraction
+        if (*end >= '0' && *end <= '9' && !strchr(s, '.')) {
+            double frac = 0.0, place = 0.1;
+            while (*end >= '0' && *end <= '9') {
+                frac += (*end - '0') * place;
+                place /= 10;
+                end++;
             }
+            val += (val < 0) ? -frac : frac;
         }
-    } while (choice != 0);
+    }
+
+    if (*end != '\0') return -1;
+
+    *out = val * scale;
+    return 0;
 }
 
-// Main Toolbox Selection Menu
-// Central hub to choose EE tools
-static void toolbox_main_menu(void)
+// Batch kernels
+// Columnar versions of the kernels above for bulk data. They work on
+// caller-provided arrays and never allocate, so the caller sizes every
+// buffer (normally from an arena) before the loop.
+
+// Series total of each row, row r uses vals[row_start[r] .. row_start[r+1])
+void series_rows(const double vals[], const size_t row_start[], int rows, double out[])
 {
-    int choice;
+    size_t i;
+    int r;
+    for (r = 0; r < rows; r++) {
+        double total = 0.0;
+        for (i = row_start[r]; i < row_start[r + 1]; i++) total += vals[i];
+        out[r] = total;
+    }
+}
+
+// Parallel total of each row, 0 if a row is empty or has a 0 Ω resistor
+void parallel_rows(const double vals[], const size_t row_start[], int rows, double out[])
+{
+    size_t i;
+    int r;
+    for (r = 0; r < rows; r++) {
+        double inv_sum = 0.0;
+        for (i = row_start[r]; i < row_start[r + 1]; i++) inv_sum += 1.0 / vals[i];
+        out[r] = (inv_sum > 0.0 && !isinf(inv_sum)) ? 1.0 / inv_sum : 0.0;
+    }
+}
 
-    do {
-        printf("\n====================================\n");
-        printf("     Electrical Engineering Toolbox\n");
-        printf("====================================\n");
-        printf("1. Resistor Color Code\n");
-        printf("2. Series/Parallel Resistors\n");
-        printf("3. RC Charge/Discharge\n");
-        printf("4. Ohm’s Law & Power\n");
-        printf("5. Signal Generation/Analysis\n");
-        printf("6. File/Log Tools\n");
-        printf("0. Back to Main Menu\n");
-
-        choice = read_int("Select: ", 0, 6);
-
-        switch (choice) {
-        case 1: module_resistor_color_code(); break;
-        case 2: module_series_parallel_resistors(); break;
-        case 3: module_rc_charge_discharge(); break;
-        case 4: module_ohm_and_power(); break;
-        case 5: module_signal_generation(); break;
-        case 6: module_file_save_and_log(); break;
-        default: break;
+void rc_charge_batch(const double R[], const double C[], const double V[],
+                     const double t[], double out[], int n)
+{
+    int i;
+    for (i = 0; i < n; i++) out[i] = V[i] * (1.0 - exp(-t[i] / (R[i] * C[i])));
+}
+
+void rc_discharge_batch(const double R[], const double C[], const double V0[],
+                        const double t[], double out[], int n)
+{
+    int i;
+    for (i = 0; i < n; i++) out[i] = V0[i] * exp(-t[i] / (R[i] * C[i]));
+}
+
+// Solves every row in place (unknowns = 0), rows without exactly two
+// known values are set to NAN. Returns the number of rows solved.
+int ohm_batch(double V[], double I[], double R[], double P[], int n)
+{
+    int i, solved = 0;
+    for (i = 0; i < n; i++) {
+        if (solve_ohm(&V[i], &I[i], &R[i], &P[i]) == 0) solved++;
+        else V[i] = I[i] = R[i] = P[i] = NAN;
+    }
+    return solved;
+}
+
+// calc_power() over columns, in double precision
+void power_batch(const double V[], const double I[], double P[], int n)
+{
+    int i;
+    for (i = 0; i < n; i++) P[i] = V[i] * I[i];
+}
+
+// LED series resistors from supply Vs, forward voltage Vf and current I:
+// the exact R, the next E-series value up (so the current never exceeds
+// I), and the current and resistor power with that value. Rows with
+// Vs <= Vf or I <= 0 are NAN. The first and last passes are plain
+// element-wise arithmetic the compiler can vectorize; validity and the
+// series lookup are in the scalar middle pass. Returns the valid rows.
+int led_batch(const double Vs[], const double Vf[], const double I[], int series,
+              double R[], double R_std[], double I_act[], double P[], int n)
+{
+    int i, valid = 0;
+
+    for (i = 0; i < n; i++) R[i] = (Vs[i] - Vf[i]) / I[i];
+    for (i = 0; i < n; i++) {
+        int ok = (Vs[i] > Vf[i] && I[i] > 0);
+        double r = ok ? eseries_ceil(series, R[i]) : -1;
+
+        if (!ok) R[i] = NAN;
+        R_std[i] = (r > 0) ? r : NAN;
+        valid += (r > 0);
+    }
+    for (i = 0; i < n; i++) {
+        I_act[i] = (Vs[i] - Vf[i]) / R_std[i];
+        P[i] = I_act[i] * I_act[i] * R_std[i];
+    }
+    return valid;
+}
+
+// Band color indices for n resistances: 4 bands (2 digits), 5 bands
+// (3 digits) or 6 bands (3 digits and tempco). Tolerance and tempco are
+// color indices from tolerance_color()/tempco_color(). Rows out of range
+// get band[0] = ENC_INVALID. Returns the number of invalid rows.
+int encode_bands_batch(const double R[], int n, int nbands, int tol, int tempco,
+                       unsigned char out[][ENC_MAX_BANDS])
+{
+    int ndigits = (nbands == 4) ? 2 : 3, bad = 0, i, sig, e;
+
+    for (i = 0; i < n; i++) {
+        unsigned char *b = out[i];
+
+        if (encode_sig(R[i], ndigits, &sig, &e) != 0) {
+            b[0] = ENC_INVALID;
+            bad++;
+            continue;
+        }
+        if (ndigits == 2) {
+            b[0] = (unsigned char)(sig / 10);
+            b[1] = (unsigned char)(sig % 10);
+        } else {
+            b[0] = (unsigned char)(sig / 100);
+            b[1] = (unsigned char)(sig / 10 % 10);
+            b[2] = (unsigned char)(sig % 10);
         }
-    } while (choice != 0);
+        b[ndigits] = (unsigned char)MULT_INDEX(e);
+        b[ndigits + 1] = (unsigned char)tol;
+        b[ndigits + 2] = (unsigned char)tempco;   // only used with 6 bands
+    }
+    return bad;
 }
 
+// x[k] = A sin(2π f (first + k) / fs), for generating long signals in chunks
+#ifdef TOOLBOX_FIXED
+void sine_batch(double A, double f, double fs, long first, double out[], int n)
+{
+    fx_dds d;
+    int i;
+
+    if (!FX_FITS(A) || !FX_FITS(f) || !FX_FITS(fs)) {
+        for (i = 0; i < n; i++) out[i] = NAN;
+        return;
+    }
+    fx_dds_init(&d, FX_FROM_DOUBLE(A), FX_FROM_DOUBLE(f), FX_FROM_DOUBLE(fs), (uint32_t)first);
+    for (i = 0; i < n; i++) out[i] = FX_TO_DOUBLE(fx_dds_next(&d));
+}
+#else
+void sine_batch(double A, double f, double fs, long first, double out[], int n)
+{
+    int i;
+    for (i = 0; i < n; i++) out[i] = A * sin(2 * PI * f * (double)(first + i) / fs);
+}
+#endif
+
+// Waveform generators, freq is in cycles per sample (f / fs)
+void gen_sine(float amp, float freq, float arr[], int n)
+{
+    int i;
+    for (i = 0; i < n; i++) arr[i] = amp * sinf((float)(2 * PI) * freq * i);
+}
+
+void gen_square(float amp, float freq, float arr[], int n)
+{
+    int i;
+    for (i = 0; i < n; i++) {
+        float phase = freq * i;
+        phase -= floorf(phase);
+        arr[i] = (phase < 0.5f) ? amp : -amp;
+    }
+}
+
+void gen_triangle(float amp, float freq, float arr[], int n)
+{
+    int i;
+    for (i = 0; i < n; i++) {
+        float phase = freq * i;
+        phase -= floorf(phase);
+        arr[i] = amp * (phase < 0.5f ? 4.0f * phase - 1.0f : 3.0f - 4.0f * phase);
+    }
+}
+
+// Writes one value per line, returns 0 on success
+int save_to_file(const char *filename, const float data[], int count)
+{
+    FILE *fp = fopen(filename, "w");
+    int i;
+
+    if (!fp) return -1;
+    for (i = 0; i < count; i++) fprintf(fp, "%.9g\n", data[i]);
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+// Main Toolbox Selection Menu
+// Central hub to choose EE tools
+static const menu_entry_t toolbox_entries[] = {
+    { 1, "Resistor Color Code",         "color-code",      NULL, &rcc_menu },
+    { 2, "Series/Parallel Resistors",   "series-parallel", module_series_parallel_resistors, NULL },
+    { 3, "RC Charge/Discharge",         "rc-calc",         module_rc_charge_discharge, NULL },
+    { 4, "Ohm’s Law & Power",           "ohm-calc",        module_ohm_and_power, NULL },
+    { 5, "Signal Generation/Analysis",  "signal",          NULL, &signal_menu },
+    { 6, "File/Log Tools",              "log",             NULL, &log_menu },
+    { 7, "Workspace",                   "workspace",       NULL, &ws_menu },
+    { 0, "Back to Main Menu",           NULL,              NULL, NULL },
+};
+
+menu_t toolbox_menu = {
+    .header  = "\n====================================\n"
+               "     Electrical Engineering Toolbox\n"
+               "====================================\n",
+    .prompt  = "Select: ",
+    .entries = toolbox_entries,
+    .count   = sizeof(toolbox_entries) / sizeof(toolbox_entries[0]),
+};
+
 
 // Functions called from main menu
 // Entry to toolbox
-void menu_item_1(void) { toolbox_main_menu(); }
+void menu_item_1(void) { menu_run(&toolbox_menu); }
 
 // Empty slots for future expansion
 void menu_item_2(void)
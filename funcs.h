@@ -1,9 +1,15 @@
 #ifndef FUNCS_H
 #define FUNCS_H
 
+#include <stddef.h>
+
 //  Menu Item Handlers  
 void menu_item_1(void);
 
+// Toolbox menu table (see menu.h), used by main.c for named commands
+struct menu;
+extern struct menu toolbox_menu;
+
 float decode_resistor(const char *band1,
                       const char *band2,
                       const char *multiplier,
@@ -21,10 +27,23 @@ void menu_item_4(void);   // Ohm's Law Calculator
 // example: float decode_resistor(char *b1, char *b2, char *mul, char *tol);
 float decode_resistor(const char *band1, const char *band2,
                       const char *multiplier, const char *tolerance);
+int   encode_resistor(double R, int *d1, int *d2, int *m);
+int   decimal_exponent(double R);    // floor(log10 R) for R in [1e-3, 1e12]
+
+// Powers of ten 10^-4 .. 10^13; divide by POW10(k) rather than multiply by
+// POW10(-k) where exactness matters (4R7 is 47 / 10, not 47 * 0.1)
+extern const double pow10_table[18];
+#define POW10(k) pow10_table[(k) + 4]
+
+const char *color_name(int index);   // "black".."white", "gold", "silver"
+int   tolerance_color(double pct);   // color index of a tolerance band, -1 if none
+int   tempco_color(int ppm);         // color index of a tempco band, -1 if none
 
 //  Series / Parallel Calculator  
 float calc_series(const float resistors[], int count);
 float calc_parallel(const float resistors[], int count);
+float calc_series_loop(const float resistors[], int count);    // no unrolling
+float calc_parallel_loop(const float resistors[], int count);
 
 // RC Charging / Discharging 
 float rc_charge(float R, float C, float V0, float t);
@@ -35,9 +54,33 @@ float calc_voltage(float I, float R);
 float calc_current(float V, float R);
 float calc_resistance(float V, float I);
 float calc_power(float V, float I);
+int   solve_ohm(double *V, double *I, double *R, double *P); // unknowns = 0,
+                                     // -2 outside the fixed-point range (fixed build)
+
+// Number parsing with SI suffixes ("4.7k", "1u", "4k7")
+int parse_si_value(const char *s, double *out);
+
+// Batch kernels (columnar, caller-provided buffers, no allocation)
+void series_rows(const double vals[], const size_t row_start[], int rows, double out[]);
+void parallel_rows(const double vals[], const size_t row_start[], int rows, double out[]);
+void rc_charge_batch(const double R[], const double C[], const double V[],
+                     const double t[], double out[], int n);
+void rc_discharge_batch(const double R[], const double C[], const double V0[],
+                        const double t[], double out[], int n);
+int  ohm_batch(double V[], double I[], double R[], double P[], int n);
+void power_batch(const double V[], const double I[], double P[], int n);   // calc_power per row
+int  led_batch(const double Vs[], const double Vf[], const double I[], int series,
+               double R[], double R_std[], double I_act[], double P[], int n);
+void sine_batch(double A, double f, double fs, long first, double out[], int n);
+
+// Bulk color encoding: out[i] holds nbands (4, 5 or 6) color indices
+#define ENC_MAX_BANDS 6
+#define ENC_INVALID   0xff
+int  encode_bands_batch(const double R[], int n, int nbands, int tol, int tempco,
+                        unsigned char out[][ENC_MAX_BANDS]);
 
 // Optional extra module 
-// Signal generator
+// Signal generator (freq in cycles per sample)
 void gen_sine(float amp, float freq, float arr[], int n);
 void gen_square(float amp, float freq, float arr[], int n);
 void gen_triangle(float amp, float freq, float arr[], int n);
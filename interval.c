@@ -0,0 +1,208 @@
+// Interval arithmetic
+// Every operation is done in the default round-to-nearest mode, whose
+// result is within half an ulp of the exact value, and each bound is then
+// moved outward unconditionally: x +- |x| 2^-52 is at least one ulp away
+// from x, so rounded to nearest it lands on or beyond the neighbouring
+// double. The step is plain arithmetic without branches or libm calls, so
+// the kernels stay vectorizable, and nothing depends on the FPU rounding
+// mode, so the compiler may schedule the arithmetic freely at any
+// optimization level. Results that underflow into the subnormal range are
+// not widened (no quantity here gets near 1e-308).
+// libm exp is not correctly rounded (error below 1 ulp), so its result is
+// moved two ulps outward.
+
+#include <math.h>
+#include "interval.h"
+#include "funcs.h"
+
+// At least one (two) ulps toward -inf / +inf
+#define STEP     0x1p-52
+#define STEP_EXP 0x1p-51
+
+static inline double down(double x) { return x - fabs(x) * STEP; }
+static inline double up(double x)   { return x + fabs(x) * STEP; }
+
+static inline double mul_dn(double a, double b) { return down(a * b); }
+static inline double mul_up(double a, double b) { return up(a * b); }
+static inline double div_dn(double a, double b) { return down(a / b); }
+static inline double div_up(double a, double b) { return up(a / b); }
+static inline double add_dn(double a, double b) { return down(a + b); }
+static inline double add_up(double a, double b) { return up(a + b); }
+
+// Bounds of a libm e^x result e for x <= 0, kept in [0, 1]
+static inline double exp_dn(double e)
+{
+    e -= e * STEP_EXP;
+    return e > 0.0 ? e : 0.0;
+}
+
+static inline double exp_up(double e)
+{
+    e += e * STEP_EXP;
+    return e < 1.0 ? e : 1.0;
+}
+
+ival ival_tol(double nominal, double pct)
+{
+    ival r;
+
+    r.lo = mul_dn(nominal, add_dn(1.0, -div_up(pct, 100.0)));
+    r.hi = mul_up(nominal, add_up(1.0, div_up(pct, 100.0)));
+    return r;
+}
+
+int ival_decode_resistor(const char *band1, const char *band2,
+                         const char *multiplier, const char *tolerance, ival *out)
+{
+    int d1 = get_digit(band1), d2 = get_digit(band2);
+    float m = get_multiplier(multiplier), tol = get_tolerance(tolerance);
+    double div;
+
+    if (d1 < 0 || d2 < 0 || m < 0.0f || tol < 0.0f) return -1;
+    if (m >= 1.0f) {
+        *out = ival_tol((d1 * 10 + d2) * (double)m, tol);
+        return 0;
+    }
+    // gold/silver (0.1, 0.01) are not exact in binary, so divide the
+    // bounds by a power of ten with the rounding for each bound
+    *out = ival_tol(d1 * 10 + d2, tol);
+    div = (m > 0.05f) ? 10.0 : 100.0;
+    out->lo = div_dn(out->lo, div);
+    out->hi = div_up(out->hi, div);
+    return 0;
+}
+
+ival ival_series(const ival r[], int count)
+{
+    ival s = { 0.0, 0.0 };
+    int i;
+
+    for (i = 0; i < count; i++) {
+        s.lo = add_dn(s.lo, r[i].lo);
+        s.hi = add_up(s.hi, r[i].hi);
+    }
+    return s;
+}
+
+// 1 / sum(1/r) is increasing in every r, so the lower bound takes the sum
+// of reciprocals rounded up and the upper bound the sum rounded down
+ival ival_parallel(const ival r[], int count)
+{
+    double s_up = 0.0, s_dn = 0.0;
+    ival p = { 0.0, 0.0 };
+    int i;
+
+    if (count <= 0) return p;
+    for (i = 0; i < count; i++) {
+        s_up = add_up(s_up, div_up(1.0, r[i].lo));
+        s_dn = add_dn(s_dn, div_dn(1.0, r[i].hi));
+    }
+    p.lo = div_dn(1.0, s_up);
+    p.hi = div_up(1.0, s_dn);
+    return p;
+}
+
+ival ival_voltage(ival I, ival R)
+{
+    ival v;
+
+    v.lo = mul_dn(I.lo, R.lo);
+    v.hi = mul_up(I.hi, R.hi);
+    return v;
+}
+
+ival ival_current(ival V, ival R)
+{
+    ival I;
+    ival_current_batch(&V, &R, &I, 1);
+    return I;
+}
+
+ival ival_power(ival V, ival I)
+{
+    return ival_voltage(V, I);
+}
+
+void ival_current_batch(const ival V[], const ival R[], ival out[], int n)
+{
+    int i;
+
+    for (i = 0; i < n; i++) {
+        out[i].lo = div_dn(V[i].lo, R[i].hi);
+        out[i].hi = div_up(V[i].hi, R[i].lo);
+    }
+}
+
+// The RC kernels run in blocks: the exponents and the final bounds are
+// plain arithmetic that the compiler vectorizes, only the exp() calls in
+// between are scalar
+#define IVAL_BLOCK 256
+
+// Exponent bounds x = t/RC of rows [0, n), n <= IVAL_BLOCK
+static void rc_exponents(const ival R[], const ival C[], const ival t[],
+                         double x_lo[], double x_hi[], int n)
+{
+    int i;
+
+    for (i = 0; i < n; i++) {
+        x_lo[i] = div_dn(t[i].lo, mul_up(R[i].hi, C[i].hi));
+        x_hi[i] = div_up(t[i].hi, mul_dn(R[i].lo, C[i].lo));
+    }
+}
+
+// Vc = V0 (1 - e^-x), x = t/RC: lowest with the smallest V0 and t and
+// the largest R and C
+void ival_rc_charge_batch(const ival R[], const ival C[], const ival V0[],
+                          const ival t[], ival out[], int n)
+{
+    double x_lo[IVAL_BLOCK], x_hi[IVAL_BLOCK];
+    int b, i, m;
+
+    for (b = 0; b < n; b += IVAL_BLOCK) {
+        m = (n - b < IVAL_BLOCK) ? n - b : IVAL_BLOCK;
+        rc_exponents(R + b, C + b, t + b, x_lo, x_hi, m);
+        for (i = 0; i < m; i++) {
+            x_lo[i] = exp(-x_lo[i]);
+            x_hi[i] = exp(-x_hi[i]);
+        }
+        for (i = 0; i < m; i++) {
+            out[b + i].lo = mul_dn(V0[b + i].lo, add_dn(1.0, -exp_up(x_lo[i])));
+            out[b + i].hi = mul_up(V0[b + i].hi, add_up(1.0, -exp_dn(x_hi[i])));
+        }
+    }
+}
+
+// Vc = V0 e^-x: lowest with the smallest V0 and C, R and the largest t
+void ival_rc_discharge_batch(const ival R[], const ival C[], const ival V0[],
+                             const ival t[], ival out[], int n)
+{
+    double x_lo[IVAL_BLOCK], x_hi[IVAL_BLOCK];
+    int b, i, m;
+
+    for (b = 0; b < n; b += IVAL_BLOCK) {
+        m = (n - b < IVAL_BLOCK) ? n - b : IVAL_BLOCK;
+        rc_exponents(R + b, C + b, t + b, x_lo, x_hi, m);
+        for (i = 0; i < m; i++) {
+            x_lo[i] = exp(-x_lo[i]);
+            x_hi[i] = exp(-x_hi[i]);
+        }
+        for (i = 0; i < m; i++) {
+            out[b + i].lo = mul_dn(V0[b + i].lo, exp_dn(x_hi[i]));
+            out[b + i].hi = mul_up(V0[b + i].hi, exp_up(x_lo[i]));
+        }
+    }
+}
+
+ival ival_rc_charge(ival R, ival C, ival V0, ival t)
+{
+    ival out;
+    ival_rc_charge_batch(&R, &C, &V0, &t, &out, 1);
+    return out;
+}
+
+ival ival_rc_discharge(ival R, ival C, ival V0, ival t)
+{
+    ival out;
+    ival_rc_discharge_batch(&R, &C, &V0, &t, &out, 1);
+    return out;
+}
@@ -0,0 +1,43 @@
+#ifndef INTERVAL_H
+#define INTERVAL_H
+
+// Interval arithmetic with directed rounding
+// Every result [lo, hi] is guaranteed to contain the exact value for any
+// inputs inside the argument intervals. Each bound is rounded outward
+// (toward -inf for lower bounds, +inf for upper bounds) without touching
+// the FPU rounding mode, so the results hold at any optimization level.
+// Intervals are assumed non-negative (resistances, voltages, times).
+
+typedef struct {
+    double lo, hi;
+} ival;
+
+// [nominal (1 - pct/100), nominal (1 + pct/100)]
+ival ival_tol(double nominal, double pct);
+
+// Color code with its tolerance band (20% without one)
+// Returns 0 on success, -1 if a color is invalid
+int  ival_decode_resistor(const char *band1, const char *band2,
+                          const char *multiplier, const char *tolerance, ival *out);
+
+//  Series / Parallel
+ival ival_series(const ival r[], int count);
+ival ival_parallel(const ival r[], int count);   // [0, 0] if empty
+
+//  Ohm's Law & Power
+ival ival_voltage(ival I, ival R);   // I R
+ival ival_current(ival V, ival R);   // V / R
+ival ival_power(ival V, ival I);     // V I
+
+// RC Charging / Discharging
+ival ival_rc_charge(ival R, ival C, ival V0, ival t);
+ival ival_rc_discharge(ival R, ival C, ival V0, ival t);
+
+// Batch versions
+void ival_current_batch(const ival V[], const ival R[], ival out[], int n);
+void ival_rc_charge_batch(const ival R[], const ival C[], const ival V0[],
+                          const ival t[], ival out[], int n);
+void ival_rc_discharge_batch(const ival R[], const ival C[], const ival V0[],
+                             const ival t[], ival out[], int n);
+
+#endif
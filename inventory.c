@@ -0,0 +1,329 @@
+// Component inventory database
+// File layout: a fixed header, then the value, fence, tolerance, package
+// and quantity arrays, each starting on an 8-byte boundary. Files are
+// written to a temporary name and renamed, so a reader never maps a
+// half-written file.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "funcs.h"
+#include "arena.h"
+#include "textio.h"
+#include "inventory.h"
+
+#define INV_MAGIC   "RINVDB1"
+#define INV_ALIGN(n) (((n) + 7) & ~(uint64_t)7)
+
+typedef struct {
+    char     magic[8];
+    uint32_t count, fences;
+    uint64_t off_value, off_fence, off_tol, off_package, off_qty;
+    uint64_t size;
+} inv_header;
+
+static int part_cmp(const void *a, const void *b)
+{
+    const inv_part *x = a, *y = b;
+
+    if (x->value != y->value) return x->value < y->value ? -1 : 1;
+    return (int)x->tol - (int)y->tol;
+}
+
+// Byte offsets of the arrays for n parts
+static void inv_layout(inv_header *h, uint32_t n)
+{
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, INV_MAGIC, sizeof(h->magic));
+    h->count = n;
+    h->fences = (n + INV_FENCE_STEP - 1) / INV_FENCE_STEP;
+    h->off_value = INV_ALIGN(sizeof(inv_header));
+    h->off_fence = h->off_value + sizeof(double) * (uint64_t)n;
+    h->off_tol = h->off_fence + sizeof(double) * (uint64_t)h->fences;
+    h->off_package = INV_ALIGN(h->off_tol + sizeof(uint16_t) * (uint64_t)n);
+    h->off_qty = INV_ALIGN(h->off_package + sizeof(uint16_t) * (uint64_t)n);
+    h->size = INV_ALIGN(h->off_qty + sizeof(uint32_t) * (uint64_t)n);
+}
+
+int inv_build(const char *path, inv_part parts[], int n)
+{
+    inv_header h;
+    char tmp[1024];
+    char *image;
+    double *value, *fence;
+    uint16_t *tol, *package;
+    uint32_t *qty;
+    FILE *fp;
+    int i, ok;
+
+    if (n < 0 || snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp)) return -1;
+    qsort(parts, (size_t)n, sizeof(inv_part), part_cmp);
+
+    inv_layout(&h, (uint32_t)n);
+    image = calloc(1, (size_t)h.size);
+    if (!image) return -1;
+    memcpy(image, &h, sizeof(h));
+    value = (double *)(image + h.off_value);
+    fence = (double *)(image + h.off_fence);
+    tol = (uint16_t *)(image + h.off_tol);
+    package = (uint16_t *)(image + h.off_package);
+    qty = (uint32_t *)(image + h.off_qty);
+    for (i = 0; i < n; i++) {
+        value[i] = parts[i].value;
+        tol[i] = parts[i].tol;
+        package[i] = parts[i].package;
+        qty[i] = parts[i].qty;
+    }
+    for (i = 0; i < (int)h.fences; i++) fence[i] = value[i * INV_FENCE_STEP];
+
+    ok = (fp = fopen(tmp, "wb")) != NULL;
+    if (ok) {
+        ok = fwrite(image, 1, (size_t)h.size, fp) == (size_t)h.size;
+        ok = (fclose(fp) == 0) && ok;
+        ok = ok && rename(tmp, path) == 0;
+        if (!ok) remove(tmp);
+    }
+    free(image);
+    return ok ? 0 : -1;
+}
+
+int inv_open(inventory *db, const char *path)
+{
+    const inv_header *h;
+    inv_header expect;
+    struct stat st;
+    void *map;
+    int fd = open(path, O_RDONLY);
+
+    memset(db, 0, sizeof(*db));
+    if (fd < 0) return -1;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(inv_header)) {
+        close(fd);
+        return -1;
+    }
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+
+    // the header must match the layout its count implies
+    h = map;
+    inv_layout(&expect, h->count);
+    if (memcmp(h, &expect, sizeof(expect)) != 0 || expect.size > (uint64_t)st.st_size) {
+        munmap(map, (size_t)st.st_size);
+        return -1;
+    }
+
+    db->map = map;
+    db->size = (size_t)st.st_size;
+    db->count = (int)h->count;
+    db->fences = (int)h->fences;
+    db->value = (const double *)((const char *)map + h->off_value);
+    db->fence = (const double *)((const char *)map + h->off_fence);
+    db->tol = (const uint16_t *)((const char *)map + h->off_tol);
+    db->package = (const uint16_t *)((const char *)map + h->off_package);
+    db->qty = (const uint32_t *)((const char *)map + h->off_qty);
+    return 0;
+}
+
+void inv_close(inventory *db)
+{
+    if (db->map) munmap(db->map, db->size);
+    memset(db, 0, sizeof(*db));
+}
+
+// First index in [lo, hi) with a[i] >= x, hi if none
+static int lower_bound(const double *a, int lo, int hi, double x)
+{
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (a[mid] < x) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+int inv_lower_bound(const inventory *db, double R)
+{
+    // fences below R; the answer lies in the page of the last of them,
+    // or at the start of the next page
+    int k = lower_bound(db->fence, 0, db->fences, R), lo, hi;
+
+    if (k == 0) return 0;
+    lo = (k - 1) * INV_FENCE_STEP;
+    hi = lo + INV_FENCE_STEP;
+    if (hi > db->count) hi = db->count;
+    return lower_bound(db->value, lo, hi, R);
+}
+
+#define INV_MATCH(db, i, package, min_qty) \
+    ((db)->qty[i] >= (min_qty) && ((package) < 0 || (db)->package[i] == (package)))
+
+int inv_find(const inventory *db, double R, double max_err, int package, uint32_t min_qty)
+{
+    double lo_limit = R * (1 - max_err), hi_limit = R * (1 + max_err);
+    int start = inv_lower_bound(db, R), up = -1, down = -1, i;
+
+    // sorted by value then tolerance: the first match upwards is the
+    // closest and tightest above R, downwards the closest below R (then
+    // walk back over equal values for the tightest tolerance)
+    for (i = start; i < db->count && db->value[i] <= hi_limit; i++)
+        if (INV_MATCH(db, i, package, min_qty)) { up = i; break; }
+    for (i = start - 1; i >= 0 && db->value[i] >= lo_limit; i--)
+        if (INV_MATCH(db, i, package, min_qty)) { down = i; break; }
+    for (i = down - 1; down >= 0 && i >= 0 && db->value[i] == db->value[down]; i--)
+        if (INV_MATCH(db, i, package, min_qty)) down = i;
+
+    if (up < 0 || down < 0) return up < 0 ? down : up;
+    if (db->value[up] - R != R - db->value[down])
+        return (db->value[up] - R < R - db->value[down]) ? up : down;
+    return db->tol[up] <= db->tol[down] ? up : down;
+}
+
+// ---- Command line ----
+
+static void inv_usage(void)
+{
+    fprintf(stderr, "Usage: main.out inventory build <parts.csv> -o parts.db   (ohms,tol %%,package,qty)\n"
+                    "       main.out inventory find <parts.db> <ohms>... [--err 5] [--package 603] [--min-qty 1]\n"
+                    "       main.out inventory stats <parts.db>\n");
+}
+
+static int inv_build_cmd(int argc, char *argv[])
+{
+    const char *in_path = NULL, *out_path = NULL;
+    textio_table table;
+    inv_part *parts;
+    size_t len;
+    char *text;
+    int i, n = 0;
+
+    for (i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) out_path = argv[++i];
+        else if (!in_path) in_path = argv[i];
+        else { inv_usage(); return 1; }
+    }
+    if (!in_path || !out_path) { inv_usage(); return 1; }
+
+    text = textio_read_file(&request_arena, in_path, &len);
+    if (!text) {
+        fprintf(stderr, "inventory: cannot read '%s'\n", in_path);
+        return 1;
+    }
+    if (textio_parse_csv(&request_arena, text, len, &table) != 0) {
+        if (table.bad_row) fprintf(stderr, "inventory: bad number on line %zu\n", table.bad_row);
+        else fprintf(stderr, "inventory: out of memory\n");
+        return 1;
+    }
+    if (table.rows > INT_MAX) {
+        fprintf(stderr, "inventory: too many rows\n");
+        return 1;
+    }
+    parts = arena_alloc(&request_arena, sizeof(inv_part) * (table.rows + 1));
+    if (!parts) {
+        fprintf(stderr, "inventory: out of memory\n");
+        return 1;
+    }
+    for (i = 0; i < (int)table.rows; i++) {
+        const double *f = table.values + table.row_start[i];
+        size_t nf = table.row_start[i + 1] - table.row_start[i];
+
+        if (nf < 4 || !(f[0] > 0) || f[1] < 0 || f[1] > 100 || f[2] < 0 || f[2] > 65535 ||
+            f[3] < 0 || f[3] > 4294967295.0) {
+            fprintf(stderr, "inventory: bad part on row %d\n", i + 1);
+            return 1;
+        }
+        parts[n].value = f[0];
+        parts[n].tol = (uint16_t)(f[1] * 100 + 0.5);
+        parts[n].package = (uint16_t)f[2];
+        parts[n].qty = (uint32_t)f[3];
+        n++;
+    }
+    if (inv_build(out_path, parts, n) != 0) {
+        fprintf(stderr, "inventory: cannot write '%s'\n", out_path);
+        return 1;
+    }
+    printf("%d parts\n", n);
+    arena_reset(&request_arena);
+    return 0;
+}
+
+static int inv_find_cmd(int argc, char *argv[])
+{
+    const char *path = NULL;
+    double err = 5, pkg = INV_ANY_PACKAGE, min_qty = 1, R;
+    inventory db;
+    int i, k, missing = 0;
+
+    // options first, so values can be given in any order around them
+    for (i = 2; i < argc; i++) {
+        double *opt = strcmp(argv[i], "--err") == 0 ? &err :
+                      strcmp(argv[i], "--package") == 0 ? &pkg :
+                      strcmp(argv[i], "--min-qty") == 0 ? &min_qty : NULL;
+        if (opt && (i + 1 >= argc || parse_si_value(argv[i + 1], opt) != 0)) {
+            fprintf(stderr, "inventory: %s needs a number\n", argv[i]);
+            return 1;
+        }
+        if (opt) { argv[i] = argv[i + 1] = NULL; i++; }
+        else if (!path) { path = argv[i]; argv[i] = NULL; }
+    }
+    if (!path) { inv_usage(); return 1; }
+    if (inv_open(&db, path) != 0) {
+        fprintf(stderr, "inventory: cannot open '%s'\n", path);
+        return 1;
+    }
+
+    for (i = 2; i < argc; i++) {
+        if (!argv[i]) continue;
+        if (parse_si_value(argv[i], &R) != 0 || R <= 0) {
+            fprintf(stderr, "inventory: bad value '%s'\n", argv[i]);
+            missing++;
+            continue;
+        }
+        k = inv_find(&db, R, err / 100, (int)pkg, (uint32_t)min_qty);
+        if (k < 0) {
+            printf("%s,none\n", argv[i]);
+            missing++;
+        } else {
+            printf("%s,%.6g,%g%%,%04u,%u,%+.2f%%\n", argv[i], db.value[k], db.tol[k] / 100.0,
+                   db.package[k], db.qty[k], (db.value[k] - R) / R * 100);
+        }
+    }
+    inv_close(&db);
+    return missing ? 1 : 0;
+}
+
+static int inv_stats_cmd(int argc, char *argv[])
+{
+    inventory db;
+    double total = 0;
+    int i, in_stock = 0;
+
+    if (argc != 3) { inv_usage(); return 1; }
+    if (inv_open(&db, argv[2]) != 0) {
+        fprintf(stderr, "inventory: cannot open '%s'\n", argv[2]);
+        return 1;
+    }
+    for (i = 0; i < db.count; i++) {
+        total += db.qty[i];
+        in_stock += (db.qty[i] > 0);
+    }
+    printf("parts=%d in_stock=%d units=%.0f", db.count, in_stock, total);
+    if (db.count) printf(" range=%.6g..%.6g", db.value[0], db.value[db.count - 1]);
+    printf("\n");
+    inv_close(&db);
+    return 0;
+}
+
+int inventory_main(int argc, char *argv[])
+{
+    if (argc >= 2 && strcmp(argv[1], "build") == 0) return inv_build_cmd(argc, argv);
+    if (argc >= 2 && strcmp(argv[1], "find") == 0) return inv_find_cmd(argc, argv);
+    if (argc >= 2 && strcmp(argv[1], "stats") == 0) return inv_stats_cmd(argc, argv);
+    inv_usage();
+    return 1;
+}
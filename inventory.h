@@ -0,0 +1,57 @@
+#ifndef INVENTORY_H
+#define INVENTORY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Component inventory database
+// An inventory file holds the parts in stock as sorted arrays (value,
+// tolerance, package, quantity), one array per field. The file is
+// memory-mapped read-only, so opening it costs no parsing and lookups
+// touch only the pages they read. A fence index holds every
+// INV_FENCE_STEP-th value, so a lookup does a binary search over the small
+// fence array and then over one page of values.
+//
+// "main.out inventory build <parts.csv> -o parts.db"  (ohms,tol %,package,qty)
+// "main.out inventory find <parts.db> <ohms>... [--err 5] [--package 603] [--min-qty 1]"
+// "main.out inventory stats <parts.db>"
+// "main.out encode 4k7 --stock parts.db" encodes the nearest part in stock
+
+#define INV_FENCE_STEP  512     // values per fence entry (4 KiB of doubles)
+#define INV_ANY_PACKAGE (-1)
+
+// Packages are the imperial size code (402, 603, 805, 1206, ...), 0 = THT
+typedef struct {
+    double   value;      // ohms
+    uint16_t tol;        // tolerance in 1/100 %
+    uint16_t package;
+    uint32_t qty;
+} inv_part;
+
+typedef struct {
+    void           *map;
+    size_t          size;
+    int             count, fences;
+    const double   *value, *fence;
+    const uint16_t *tol, *package;
+    const uint32_t *qty;
+} inventory;
+
+// Writes n parts (in any order) as an inventory file, 0 on success
+int inv_build(const char *path, inv_part parts[], int n);
+
+// Maps an inventory file, 0 on success, -1 if missing or malformed
+int inv_open(inventory *db, const char *path);
+void inv_close(inventory *db);
+
+// Index of the first part with value >= R (count if none)
+int inv_lower_bound(const inventory *db, double R);
+
+// Index of the part closest to R within a relative error of max_err
+// (0.05 = 5%) with the package (or INV_ANY_PACKAGE) and at least min_qty
+// in stock; ties go to the tighter tolerance. -1 if there is none.
+int inv_find(const inventory *db, double R, double max_err, int package, uint32_t min_qty);
+
+int inventory_main(int argc, char *argv[]);
+
+#endif
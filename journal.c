@@ -0,0 +1,93 @@
+// Progress journal for long batch runs
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "calclog.h"
+#include "journal.h"
+
+typedef struct {
+    journal_ckpt *last;
+    int           found;
+} journal_scan;
+
+static int journal_keep_last(const void *data, size_t len, void *ctx)
+{
+    journal_scan *js = ctx;
+
+    if (len == sizeof(journal_ckpt)) {
+        memcpy(js->last, data, len);
+        js->found = 1;
+    }
+    return 0;
+}
+
+int journal_last(const char *path, journal_ckpt *out)
+{
+    journal_scan js = { out, 0 };
+    clog_stats st;
+
+    memset(out, 0, sizeof(*out));
+    if (clog_scan(path, journal_keep_last, &js, &st) != 0) return -1;
+    return js.found ? 0 : -1;
+}
+
+static void *journal_writer(void *arg)
+{
+    journal_t *j = arg;
+
+    pthread_mutex_lock(&j->lock);
+    for (;;) {
+        journal_ckpt c;
+
+        while (!j->has_pending && !j->stop) pthread_cond_wait(&j->wake, &j->lock);
+        if (!j->has_pending) break;
+        c = j->pending;
+        j->has_pending = 0;
+        pthread_mutex_unlock(&j->lock);
+
+        // output first, then the checkpoint that points past it
+        if (fdatasync(j->out_fd) != 0 || clog_append(j->path, &c, sizeof(c)) != 0) j->failed = 1;
+
+        pthread_mutex_lock(&j->lock);
+    }
+    pthread_mutex_unlock(&j->lock);
+    return NULL;
+}
+
+int journal_start(journal_t *j, const char *path, int out_fd, int resume)
+{
+    memset(j, 0, sizeof(*j));
+    j->path = path;
+    j->out_fd = out_fd;
+    if (!resume && clog_clear(path) != 0) return -1;
+    pthread_mutex_init(&j->lock, NULL);
+    pthread_cond_init(&j->wake, NULL);
+    if (pthread_create(&j->thread, NULL, journal_writer, j) != 0) {
+        pthread_mutex_destroy(&j->lock);
+        pthread_cond_destroy(&j->wake);
+        return -1;
+    }
+    return 0;
+}
+
+void journal_post(journal_t *j, const journal_ckpt *c)
+{
+    pthread_mutex_lock(&j->lock);
+    j->pending = *c;
+    j->has_pending = 1;
+    pthread_cond_signal(&j->wake);
+    pthread_mutex_unlock(&j->lock);
+}
+
+int journal_stop(journal_t *j)
+{
+    pthread_mutex_lock(&j->lock);
+    j->stop = 1;
+    pthread_cond_signal(&j->wake);
+    pthread_mutex_unlock(&j->lock);
+    pthread_join(j->thread, NULL);
+    pthread_mutex_destroy(&j->lock);
+    pthread_cond_destroy(&j->wake);
+    return j->failed ? -1 : 0;
+}
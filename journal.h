@@ -0,0 +1,47 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stdint.h>
+#include <pthread.h>
+
+// Progress journal for long batch runs
+// A run posts a checkpoint after each segment of rows whose output has
+// been handed to the output file. A writer thread makes the output durable
+// (fdatasync) and only then appends the checkpoint to the journal, as a
+// calclog frame, so a checkpoint never claims output that could be lost
+// and a checkpoint torn by a crash is skipped on the next read. Posting
+// only copies the checkpoint under a mutex; if the writer is still busy,
+// a newer checkpoint replaces the pending one.
+
+typedef struct {
+    uint64_t input_size;    // identity of the run: input file size and
+    int64_t  input_mtime;   // modification time, the batch kind and the
+    uint32_t kind, flags;   // options that change the output
+    uint64_t rows_done;     // rows whose output is complete
+    uint64_t out_bytes;     // output file length after those rows
+} journal_ckpt;
+
+typedef struct {
+    const char     *path;
+    int             out_fd;
+    pthread_t       thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;
+    journal_ckpt    pending;
+    int             has_pending, stop, failed;
+} journal_t;
+
+// Last valid checkpoint of a journal file, 0 if there is one
+int journal_last(const char *path, journal_ckpt *out);
+
+// Starts the writer. A fresh run clears any old journal; a resumed run
+// appends to it, so its last checkpoint stays valid until a newer one is
+// durable.
+int journal_start(journal_t *j, const char *path, int out_fd, int resume);
+
+void journal_post(journal_t *j, const journal_ckpt *c);
+
+// Writes the pending checkpoint and stops the writer, -1 if any write failed
+int journal_stop(journal_t *j);
+
+#endif
@@ -0,0 +1,162 @@
+// Bulk color-band labels
+// Values are encoded in parallel by encode_bands_batch() into one small
+// row of color indices each; the writer then copies precomputed strings
+// for each color into the output buffer, so no row is formatted with
+// printf.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+#include "funcs.h"
+#include "arena.h"
+#include "textio.h"
+#include "labels.h"
+#include "scheduler.h"
+
+#define LABELS_GRAIN 16384
+
+enum { LABELS_NAMES, LABELS_INDEX, LABELS_RGB };
+
+static const char *const format_names[] = { "names", "index", "rgb" };
+
+// Swatch colors, index = color index
+static const char *const color_rgb[12] = {
+    "#000000", "#964B00", "#FF0000", "#FFA500", "#FFFF00", "#008000",
+    "#0000FF", "#8F00FF", "#808080", "#FFFFFF", "#D4AF37", "#C0C0C0"
+};
+
+static const char *const color_number[12] = {
+    "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "10", "11"
+};
+
+static void labels_usage(void)
+{
+    fprintf(stderr, "Usage: main.out labels <in.csv> [--bands 4|5|6] [--tol %%] [--tempco ppm]\n"
+                    "                       [--format names|index|rgb] [-o out.csv] [--threads N]\n");
+}
+
+typedef struct {
+    const double  *R;
+    int            nbands, tol, tempco;
+    unsigned char (*bands)[ENC_MAX_BANDS];
+} labels_job;
+
+static void labels_chunk(size_t lo, size_t hi, void *arg)
+{
+    const labels_job *j = arg;
+    encode_bands_batch(j->R + lo, (int)(hi - lo), j->nbands, j->tol, j->tempco, j->bands + lo);
+}
+
+static void labels_write(textio_out *o, unsigned char (*bands)[ENC_MAX_BANDS],
+                         int rows, int nbands, int format)
+{
+    static const char *const invalid = "invalid\n";
+    const char *const *names = (format == LABELS_RGB) ? color_rgb : color_number;
+    size_t len[12];
+    int r, b;
+
+    if (format == LABELS_NAMES) {
+        static const char *by_name[12];
+        for (b = 0; b < 12; b++) by_name[b] = color_name(b);
+        names = by_name;
+    }
+    for (b = 0; b < 12; b++) len[b] = strlen(names[b]);
+
+    for (r = 0; r < rows; r++) {
+        const unsigned char *code = bands[r];
+
+        if (code[0] == ENC_INVALID) {
+            textio_write(o, invalid, 8);
+            continue;
+        }
+        for (b = 0; b < nbands; b++) {
+            textio_write(o, names[code[b]], len[code[b]]);
+            textio_write(o, b + 1 < nbands ? "," : "\n", 1);
+        }
+    }
+}
+
+int labels_main(int argc, char *argv[])
+{
+    const char *in_path = NULL, *out_path = NULL;
+    double tol = -1, tempco = 100;
+    int i, nbands = 4, format = LABELS_NAMES, tol_color, tempco_color_idx, bad;
+    textio_table table;
+    textio_out out;
+    labels_job job;
+    double *R;
+    size_t len;
+    char *text;
+    FILE *fp = stdout;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) out_path = argv[++i];
+        else if (strcmp(argv[i], "--bands") == 0 && i + 1 < argc) nbands = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tol") == 0 && i + 1 < argc) tol = atof(argv[++i]);
+        else if (strcmp(argv[i], "--tempco") == 0 && i + 1 < argc) tempco = atof(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) sched_set_threads(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            for (format = 0; format < 3; format++)
+                if (strcmp(argv[i + 1], format_names[format]) == 0) break;
+            if (format == 3) { labels_usage(); return 1; }
+            i++;
+        }
+        else if (!in_path) in_path = argv[i];
+        else { labels_usage(); return 1; }
+    }
+    if (!in_path || nbands < 4 || nbands > 6) { labels_usage(); return 1; }
+
+    // precision resistors (5/6 bands) default to 1%, 4-band to 5%
+    if (tol < 0) tol = (nbands == 4) ? 5.0 : 1.0;
+    tol_color = tolerance_color(tol);
+    tempco_color_idx = tempco_color((int)tempco);
+    if (tol_color < 0 || tempco_color_idx < 0) {
+        fprintf(stderr, "labels: no color band for --tol %g / --tempco %g\n", tol, tempco);
+        return 1;
+    }
+
+    text = textio_read_file(&request_arena, in_path, &len);
+    if (!text) {
+        fprintf(stderr, "labels: cannot read '%s'\n", in_path);
+        return 1;
+    }
+    if (textio_parse_csv(&request_arena, text, len, &table) != 0) {
+        if (table.bad_row) fprintf(stderr, "labels: bad number on line %zu\n", table.bad_row);
+        else fprintf(stderr, "labels: out of memory\n");
+        return 1;
+    }
+
+    if (table.rows > INT_MAX) {
+        fprintf(stderr, "labels: too many rows\n");
+        return 1;
+    }
+    R = arena_alloc(&request_arena, sizeof(double) * (table.rows + 1));
+    job.bands = arena_alloc(&request_arena, ENC_MAX_BANDS * (table.rows + 1));
+    if (!R || !job.bands) {
+        fprintf(stderr, "labels: out of memory\n");
+        return 1;
+    }
+    for (i = 0; i < (int)table.rows; i++)
+        R[i] = (table.row_start[i + 1] > table.row_start[i]) ? table.values[table.row_start[i]] : 0.0;
+
+    job.R = R;
+    job.nbands = nbands;
+    job.tol = tol_color;
+    job.tempco = tempco_color_idx;
+    parallel_for(0, table.rows, LABELS_GRAIN, labels_chunk, &job);
+
+    if (out_path && !(fp = fopen(out_path, "w"))) {
+        fprintf(stderr, "labels: cannot write '%s'\n", out_path);
+        return 1;
+    }
+    textio_out_open(&out, fp);
+    labels_write(&out, job.bands, (int)table.rows, nbands, format);
+    textio_out_close(&out);
+    if (fp != stdout) fclose(fp);
+
+    for (bad = 0, i = 0; i < (int)table.rows; i++) bad += (job.bands[i][0] == ENC_INVALID);
+    if (bad) fprintf(stderr, "labels: %d value(s) outside the color code range\n", bad);
+    arena_reset(&request_arena);
+    return 0;
+}
@@ -0,0 +1,12 @@
+#ifndef LABELS_H
+#define LABELS_H
+
+// Bulk color-band labels
+// "main.out labels <in.csv> [--bands 4|5|6] [--tol 5] [--tempco 100]
+//  [--format names|index|rgb] [-o out.csv] [--threads N]"
+// encodes the first column of every row and writes one line of band
+// colors per row (names, color indices or #RRGGBB swatches).
+
+int labels_main(int argc, char *argv[]);
+
+#endif
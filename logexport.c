@@ -0,0 +1,428 @@
+// Calculation log export
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "calclog.h"
+#include "logexport.h"
+#include "scheduler.h"
+
+#define LOGX_LINE_MAX 512    // room reserved per record in a text buffer
+
+// One piece of the log and what it produced
+typedef struct {
+    size_t   lo, hi;         // byte range in the log
+    char    *buf;            // text output (CSV, JSONL)
+    size_t   len, cap;
+    uint64_t first_row;      // columnar: row of the first record
+    long     rows, text, filtered, torn;
+    size_t   skipped;
+    int      err;            // errno of a failure, 0 = none
+} logx_piece;
+
+typedef struct {
+    const unsigned char *log;
+    logx_piece          *pieces;
+    int                  format, module, counting, fd;
+    logx_col_header      h;
+} logx_job;
+
+// Per-piece state while its records are visited
+typedef struct {
+    const logx_job *job;
+    logx_piece     *p;
+    int64_t        *time;    // columnar slices, NULL when counting
+    uint8_t        *mod;
+    double         *f[LOGREC_MAX_FIELDS];
+} logx_ctx;
+
+// ---- Text formats ----
+
+static size_t put_int(char *o, long long v)
+{
+    char tmp[24], *p = tmp + sizeof(tmp);
+    unsigned long long u = v < 0 ? 0ull - (unsigned long long)v : (unsigned long long)v;
+    size_t n;
+
+    do { *--p = (char)('0' + u % 10); u /= 10; } while (u);
+    if (v < 0) *--p = '-';
+    n = (size_t)(tmp + sizeof(tmp) - p);
+    memcpy(o, p, n);
+    return n;
+}
+
+// Shortest of %.15g and %.17g that reads back exactly; whole numbers
+// (counts, band indices) skip printf
+static size_t put_number(char *o, double v)
+{
+    int n;
+
+    if (v > -1e15 && v < 1e15 && v == (double)(long long)v) return put_int(o, (long long)v);
+    n = snprintf(o, 32, "%.15g", v);
+    if (strtod(o, NULL) != v) n = snprintf(o, 32, "%.17g", v);
+    return (size_t)n;
+}
+
+static size_t put_str(char *o, const char *s)
+{
+    size_t n = strlen(s);
+
+    memcpy(o, s, n);
+    return n;
+}
+
+// With --module only that module's fields are columns
+static size_t format_csv(char *o, const logrec *r, int module)
+{
+    int i, cols = module ? logrec_field_count(module) : LOGREC_MAX_FIELDS;
+    size_t n = 0;
+
+    n += put_int(o + n, r->time_us);
+    o[n++] = ',';
+    n += put_str(o + n, logrec_module_name(r->module));
+    for (i = 0; i < cols; i++) {
+        o[n++] = ',';
+        if (i < r->nfields) n += put_number(o + n, r->f[i]);
+    }
+    o[n++] = '\n';
+    return n;
+}
+
+// Module and field names are plain identifiers, nothing needs escaping;
+// JSON has no NaN or infinity, those become null
+static size_t format_jsonl(char *o, const logrec *r)
+{
+    size_t n = 0;
+    int i;
+
+    n += put_str(o + n, "{\"time_us\":");
+    n += put_int(o + n, r->time_us);
+    n += put_str(o + n, ",\"module\":\"");
+    n += put_str(o + n, logrec_module_name(r->module));
+    o[n++] = '"';
+    for (i = 0; i < r->nfields; i++) {
+        n += put_str(o + n, ",\"");
+        n += put_str(o + n, logrec_field_name(r->module, i));
+        n += put_str(o + n, "\":");
+        n += isfinite(r->f[i]) ? put_number(o + n, r->f[i]) : put_str(o + n, "null");
+    }
+    n += put_str(o + n, "}\n");
+    return n;
+}
+
+static int reserve(logx_piece *p, size_t extra)
+{
+    char *nb;
+    size_t cap = p->cap ? p->cap : (1u << 20);
+
+    if (p->len + extra <= p->cap) return 0;
+    while (p->len + extra > cap) cap *= 2;
+    nb = realloc(p->buf, cap);
+    if (!nb) return -1;
+    p->buf = nb;
+    p->cap = cap;
+    return 0;
+}
+
+static int logx_visit(const void *data, size_t len, void *arg)
+{
+    logx_ctx *c = arg;
+    logx_piece *p = c->p;
+    const logx_job *job = c->job;
+    logrec r;
+    int i;
+
+    if (logrec_decode(data, len, &r) != 0) { p->text++; return 0; }
+    if (job->module && r.module != job->module) { p->filtered++; return 0; }
+
+    if (job->format == LOGX_COL) {
+        if (!job->counting) {
+            c->time[p->rows] = r.time_us;
+            c->mod[p->rows] = r.module;
+            for (i = 0; i < LOGREC_MAX_FIELDS; i++)
+                c->f[i][p->rows] = i < r.nfields ? r.f[i] : NAN;
+        }
+    } else {
+        if (reserve(p, LOGX_LINE_MAX) != 0) { p->err = ENOMEM; return 1; }
+        p->len += job->format == LOGX_CSV ? format_csv(p->buf + p->len, &r, job->module)
+                                          : format_jsonl(p->buf + p->len, &r);
+    }
+    p->rows++;
+    return 0;
+}
+
+// ---- Output ----
+
+static int write_all(int fd, const void *data, size_t len)
+{
+    const char *p = data;
+
+    while (len) {
+        ssize_t n = write(fd, p, len);
+
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int pwrite_all(int fd, const void *data, size_t len, uint64_t off)
+{
+    const char *p = data;
+
+    while (len) {
+        ssize_t n = pwrite(fd, p, len, (off_t)off);
+
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+        off += (uint64_t)n;
+    }
+    return 0;
+}
+
+// Columnar pass 2: fills this piece's rows and writes each column slice
+static void write_columns(const logx_job *job, logx_piece *p)
+{
+    const logx_col_header *h = &job->h;
+    size_t n = (size_t)p->rows;
+    logx_ctx c = { job, p, NULL, NULL, { NULL } };
+    clog_stats st;
+    void *mem;
+    int i, ok;
+
+    if (n == 0) return;
+    mem = malloc(n * (sizeof(int64_t) + 1 + sizeof(double) * LOGREC_MAX_FIELDS));
+    if (!mem) { p->err = ENOMEM; return; }
+    c.time = mem;
+    for (i = 0; i < LOGREC_MAX_FIELDS; i++) c.f[i] = (double *)(c.time + n) + i * n;
+    c.mod = (uint8_t *)(c.f[LOGREC_MAX_FIELDS - 1] + n);
+
+    p->rows = 0;
+    clog_scan_buffer(job->log + p->lo, p->hi - p->lo, logx_visit, &c, &st);
+
+    ok = p->rows == (long)n &&
+         pwrite_all(job->fd, c.time, n * sizeof(int64_t), h->off_time + p->first_row * 8) == 0 &&
+         pwrite_all(job->fd, c.mod, n, h->off_module + p->first_row) == 0;
+    for (i = 0; ok && i < LOGREC_MAX_FIELDS; i++)
+        ok = pwrite_all(job->fd, c.f[i], n * sizeof(double), h->off_field[i] + p->first_row * 8) == 0;
+    if (!ok) p->err = errno ? errno : EIO;
+    free(mem);
+}
+
+static void logx_body(size_t lo, size_t hi, void *arg)
+{
+    logx_job *job = arg;
+    size_t k;
+
+    for (k = lo; k < hi; k++) {
+        logx_piece *p = &job->pieces[k];
+        logx_ctx c = { job, p, NULL, NULL, { NULL } };
+        clog_stats st;
+
+        if (job->format == LOGX_COL && !job->counting) {
+            write_columns(job, p);
+            continue;
+        }
+        p->len = 0;
+        p->rows = p->text = p->filtered = 0;
+        clog_scan_buffer(job->log + p->lo, p->hi - p->lo, logx_visit, &c, &st);
+        p->torn = st.torn;
+        p->skipped = st.skipped;
+    }
+}
+
+static void add_stats(logx_stats *st, const logx_piece *p)
+{
+    st->rows += p->rows;
+    st->text += p->text;
+    st->filtered += p->filtered;
+    st->torn += p->torn;
+    st->skipped += p->skipped;
+}
+
+static void col_layout(logx_col_header *h, uint64_t rows)
+{
+    int i;
+
+    memset(h, 0, sizeof(*h));
+    h->magic = LOGX_COL_MAGIC;
+    h->version = LOGX_COL_VERSION;
+    h->rows = rows;
+    h->off_time = sizeof(*h);
+    h->off_module = h->off_time + rows * 8;
+    h->off_field[0] = h->off_module + ((rows + 7) & ~(uint64_t)7);
+    for (i = 1; i < LOGREC_MAX_FIELDS; i++) h->off_field[i] = h->off_field[i - 1] + rows * 8;
+}
+
+static void text_header(char *o, int format, int module)
+{
+    int i;
+
+    *o = '\0';
+    if (format != LOGX_CSV) return;
+    strcat(o, "time_us,module");
+    for (i = 0; i < LOGREC_MAX_FIELDS; i++) {
+        const char *name = module ? logrec_field_name(module, i) : NULL;
+        size_t n = strlen(o);
+
+        if (module && !name) continue;
+        if (name) snprintf(o + n, 32, ",%s", name);
+        else snprintf(o + n, 32, ",f%d", i);
+    }
+    strcat(o, "\n");
+}
+
+int logx_export(const char *path, const char *out_path, int format, int module,
+                logx_stats *st)
+{
+    logx_job job;
+    logx_piece *pieces = NULL;
+    size_t size = 0, *bounds = NULL, npieces, wave, k, j;
+    struct stat sb;
+    void *map = NULL;
+    char head[256];
+    int fd, out = -1, err = 0;
+
+    memset(st, 0, sizeof(*st));
+    memset(&job, 0, sizeof(job));
+    job.format = format;
+    job.module = module;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0 && errno != ENOENT) return -1;
+    if (fd >= 0) {                          // a missing log exports as empty
+        if (fstat(fd, &sb) != 0) { err = errno; close(fd); errno = err; return -1; }
+        size = (size_t)sb.st_size;
+        if (size) map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) return -1;
+        if (map) madvise(map, size, MADV_SEQUENTIAL);
+    }
+    job.log = map;
+
+    // piece boundaries, each at a frame start
+    npieces = (size + LOGX_CHUNK - 1) / LOGX_CHUNK;
+    wave = (size_t)sched_threads() * 2;
+    bounds = malloc((npieces + 1) * sizeof(size_t));
+    pieces = calloc(format == LOGX_COL ? npieces + 1 : wave, sizeof(logx_piece));
+    if (!bounds || !pieces) { err = ENOMEM; goto done; }
+    bounds[0] = 0;
+    for (k = 1; k < npieces; k++) bounds[k] = clog_sync(job.log, size, k * (size_t)LOGX_CHUNK);
+    bounds[npieces] = size;
+    job.pieces = pieces;
+
+    if (strcmp(out_path, "-") == 0 && format != LOGX_COL) out = STDOUT_FILENO;
+    else out = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) { err = errno; goto done; }
+    job.fd = out;
+
+    if (format == LOGX_COL) {
+        uint64_t rows = 0;
+
+        // pass 1 counts the rows of every piece, pass 2 writes them
+        for (k = 0; k < npieces; k++) { pieces[k].lo = bounds[k]; pieces[k].hi = bounds[k + 1]; }
+        job.counting = 1;
+        parallel_for(0, npieces, 1, logx_body, &job);
+        for (k = 0; k < npieces; k++) {
+            pieces[k].first_row = rows;
+            rows += (uint64_t)pieces[k].rows;
+            add_stats(st, &pieces[k]);
+        }
+        col_layout(&job.h, rows);
+        if (ftruncate(out, (off_t)(job.h.off_field[LOGREC_MAX_FIELDS - 1] + rows * 8)) != 0 ||
+            pwrite_all(out, &job.h, sizeof(job.h), 0) != 0) {
+            err = errno;
+            goto done;
+        }
+        job.counting = 0;
+        parallel_for(0, npieces, 1, logx_body, &job);
+        for (k = 0; k < npieces && !err; k++) err = pieces[k].err;
+        goto done;
+    }
+
+    text_header(head, format, module);
+    if (write_all(out, head, strlen(head)) != 0) { err = errno; goto done; }
+
+    // a wave of pieces is converted in parallel, then written in order
+    for (k = 0; k < npieces && !err; k += wave) {
+        size_t n = npieces - k < wave ? npieces - k : wave;
+
+        for (j = 0; j < n; j++) { pieces[j].lo = bounds[k + j]; pieces[j].hi = bounds[k + j + 1]; }
+        parallel_for(0, n, 1, logx_body, &job);
+        for (j = 0; j < n && !err; j++) {
+            add_stats(st, &pieces[j]);
+            if (pieces[j].err) err = pieces[j].err;
+            else if (write_all(out, pieces[j].buf, pieces[j].len) != 0) err = errno ? errno : EIO;
+        }
+    }
+
+done:
+    if (out >= 0 && out != STDOUT_FILENO && close(out) != 0 && !err) err = errno;
+    if (pieces && format != LOGX_COL)
+        for (j = 0; j < wave; j++) free(pieces[j].buf);
+    free(pieces);
+    free(bounds);
+    if (map) munmap(map, size);
+    errno = err;
+    return err ? -1 : 0;
+}
+
+// ---- Command line ----
+
+static void logx_usage(void)
+{
+    fprintf(stderr, "Usage: main.out log export [--format csv|jsonl|col] [--module name] -o out\n"
+                    "                           [--file " LOG_FILENAME "] [--threads N]\n");
+}
+
+int logx_main(int argc, char *argv[])
+{
+    const char *path = LOG_FILENAME, *out_path = NULL;
+    int format = LOGX_CSV, module = 0, i;
+    logx_stats st;
+
+    for (i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--file") == 0 && i + 1 < argc) path = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) out_path = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) sched_set_threads(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            const char *f = argv[++i];
+
+            if (strcmp(f, "csv") == 0) format = LOGX_CSV;
+            else if (strcmp(f, "jsonl") == 0) format = LOGX_JSONL;
+            else if (strcmp(f, "col") == 0) format = LOGX_COL;
+            else { logx_usage(); return 1; }
+        } else if (strcmp(argv[i], "--module") == 0 && i + 1 < argc) {
+            const char *name = argv[++i];
+
+            for (module = 1; module < LR_MODULE_COUNT; module++)
+                if (strcmp(logrec_module_name(module), name) == 0) break;
+            if (module == LR_MODULE_COUNT) {
+                fprintf(stderr, "log export: unknown module '%s'\n", name);
+                return 1;
+            }
+        } else { logx_usage(); return 1; }
+    }
+    if (!out_path || (format == LOGX_COL && strcmp(out_path, "-") == 0)) { logx_usage(); return 1; }
+
+    if (logx_export(path, out_path, format, module, &st) != 0) {
+        fprintf(stderr, "log export: %s\n", strerror(errno));
+        return 1;
+    }
+    fprintf(stderr, "rows=%ld text_skipped=%ld", st.rows, st.text);
+    if (module) fprintf(stderr, " other_modules=%ld", st.filtered);
+    if (st.torn) fprintf(stderr, " torn=%ld skipped_bytes=%zu", st.torn, st.skipped);
+    fputc('\n', stderr);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#ifndef LOGEXPORT_H
+#define LOGEXPORT_H
+
+#include <stdint.h>
+#include "logrec.h"
+
+// Calculation log export
+// "main.out log export [--format csv|jsonl|col] [--module ohm] -o out
+//                      [--file calc_log.bin] [--threads N]"
+//
+// The log is memory-mapped and cut into LOGX_CHUNK pieces, each moved
+// forward to the next valid frame (clog_sync), so the pieces scan on their
+// own and are converted in parallel. CSV and JSON Lines pieces are written
+// out in order as whole buffers; the columnar file is sized from a counting
+// pass first and every piece then writes its slice of each column with one
+// pwrite(). Only typed records are exported, free-text records of older
+// logs are counted and skipped.
+//
+// CSV:   time_us,module,f0..f5 (the field names with --module), absent
+//        fields empty
+// JSONL: {"time_us":...,"module":"ohm","V":5,"I":0.05,...}
+// col:   logx_col_header, then the columns at the offsets it gives: time_us
+//        as int64, module as uint8 (padded to 8 bytes), then
+//        LOGREC_MAX_FIELDS columns of doubles, NaN where a module has fewer
+//        fields. Host byte order, like the log.
+
+#define LOGX_CHUNK     (4u << 20)    // log bytes per piece
+#define LOGX_COL_MAGIC 0x43474c43u   // "CLGC" in the file (little endian)
+#define LOGX_COL_VERSION 1
+
+typedef struct {
+    uint32_t magic, version;
+    uint64_t rows;
+    uint64_t off_time, off_module;
+    uint64_t off_field[LOGREC_MAX_FIELDS];
+} logx_col_header;
+
+enum { LOGX_CSV, LOGX_JSONL, LOGX_COL };
+
+typedef struct {
+    long   rows;          // records exported
+    long   text;          // free-text records skipped
+    long   filtered;      // typed records of other modules (--module)
+    long   torn;
+    size_t skipped;
+} logx_stats;
+
+// Exports the log at path to out_path; module 0 exports every module.
+// 0 on success, -1 on error (errno set).
+int logx_export(const char *path, const char *out_path, int format, int module,
+                logx_stats *st);
+
+int logx_main(int argc, char *argv[]);
+
+#endif
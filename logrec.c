@@ -0,0 +1,161 @@
+// Typed calculation log records
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "logrec.h"
+
+typedef struct {
+    const char *name;
+    int         nfields;
+    const char *field[LOGREC_MAX_FIELDS];
+} logrec_schema;
+
+// Indexed by logrec_module; append new modules and fields at the end only,
+// changing the meaning of a field needs a new LOGREC_VERSION. Records
+// written before a field was appended decode with fewer fields.
+static const logrec_schema schemas[LR_MODULE_COUNT] = {
+    [LR_COLOR_TO_R]      = { "color-to-r",      6, { "b1", "b2", "m", "t", "R", "tol_pct" } },
+    [LR_R_TO_COLOR]      = { "r-to-color",      4, { "R", "d1", "d2", "m" } },
+    [LR_MARKING]         = { "marking",         5, { "family", "value", "tol_pct", "tol_abs",
+                                                        "tol_minus_pct" } },
+    [LR_SERIES_PARALLEL] = { "series-parallel", 3, { "n", "mode", "total" } },
+    [LR_RC_CHARGE]       = { "rc-charge",       5, { "R", "C", "V", "t", "Vc" } },
+    [LR_RC_DISCHARGE]    = { "rc-discharge",    5, { "R", "C", "V0", "t", "Vc" } },
+    [LR_OHM]             = { "ohm",             4, { "V", "I", "R", "P" } },
+    [LR_SIGNAL]          = { "signal",          3, { "f", "T", "w" } },
+    [LR_SINE]            = { "sine",            4, { "f", "A", "fs", "N" } },
+};
+
+static int valid_module(int module)
+{
+    return module > 0 && module < LR_MODULE_COUNT;
+}
+
+void logrec_init(logrec *r, logrec_module module)
+{
+    struct timespec ts;
+
+    memset(r, 0, sizeof(*r));
+    r->version = LOGREC_VERSION;
+    r->module  = (uint8_t)module;
+    r->nfields = (uint8_t)schemas[module].nfields;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    r->time_us = (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+const char *logrec_module_name(int module)
+{
+    return valid_module(module) ? schemas[module].name : NULL;
+}
+
+const char *logrec_field_name(int module, int field)
+{
+    if (!valid_module(module) || field < 0 || field >= schemas[module].nfields) return NULL;
+    return schemas[module].field[field];
+}
+
+int logrec_field_count(int module)
+{
+    return valid_module(module) ? schemas[module].nfields : 0;
+}
+
+// Header: version, module, nfields, 5 reserved bytes, time_us; the struct
+// has the same layout, so encoding is a copy of its first bytes
+size_t logrec_encode(const logrec *r, unsigned char *out)
+{
+    size_t n = LOGREC_HEADER + 8 * (size_t)r->nfields;
+
+    memcpy(out, r, n);
+    return n;
+}
+
+int logrec_decode(const void *data, size_t len, logrec *r)
+{
+    const unsigned char *p = data;
+
+    if (len < LOGREC_HEADER || p[0] != LOGREC_VERSION || !valid_module(p[1])
+        || p[2] > schemas[p[1]].nfields || len != LOGREC_HEADER + 8 * (size_t)p[2])
+        return -1;
+    memset(r, 0, sizeof(*r));
+    memcpy(r, data, len);
+    return 0;
+}
+
+// ---- Pretty printer ----
+
+// Appends s (n bytes) if it fits
+static size_t put(char *out, size_t pos, size_t size, const char *s, size_t n)
+{
+    if (pos + n >= size) n = pos + 1 < size ? size - 1 - pos : 0;
+    memcpy(out + pos, s, n);
+    return pos + n;
+}
+
+// Whole numbers (band indices, counts, most entered values) are the common
+// case and skip printf; the rest take the "%.6g" of the old text log
+static size_t put_number(char *out, size_t pos, size_t size, double v)
+{
+    char tmp[32];
+    int n;
+
+    // range first: casting NaN, inf or a huge value to long long is undefined
+    if (v > -1e15 && v < 1e15 && v == (double)(long long)v) {
+        unsigned long long u = (unsigned long long)(v < 0 ? -v : v);
+        char *p = tmp + sizeof(tmp);
+
+        do { *--p = (char)('0' + u % 10); u /= 10; } while (u);
+        if (v < 0) *--p = '-';
+        return put(out, pos, size, p, (size_t)(tmp + sizeof(tmp) - p));
+    }
+    n = snprintf(tmp, sizeof(tmp), "%.6g", v);
+    return put(out, pos, size, tmp, (size_t)n);
+}
+
+// Records come in time order, so consecutive ones usually share the second
+// and the date text is only rebuilt when it changes
+static _Thread_local time_t stamp_sec = -1;
+static _Thread_local char   stamp_text[32];
+static _Thread_local size_t stamp_len;
+
+static size_t put_time(char *out, size_t pos, size_t size, int64_t time_us)
+{
+    time_t sec = (time_t)(time_us / 1000000);
+
+    if (sec != stamp_sec) {
+        struct tm tm;
+
+        localtime_r(&sec, &tm);
+        stamp_len = strftime(stamp_text, sizeof(stamp_text), "%Y-%m-%d %H:%M:%S", &tm);
+        stamp_sec = sec;
+    }
+    return put(out, pos, size, stamp_text, stamp_len);
+}
+
+size_t logrec_format(const void *data, size_t len, char *out, size_t size)
+{
+    const logrec_schema *s;
+    logrec r;
+    size_t pos = 0;
+    int i;
+
+    if (size == 0) return 0;
+    if (logrec_decode(data, len, &r) != 0) {
+        pos = put(out, 0, size, data, len);   // free text of an older log
+        out[pos] = '\0';
+        return pos;
+    }
+
+    s = &schemas[r.module];
+    pos = put_time(out, pos, size, r.time_us);
+    pos = put(out, pos, size, " ", 1);
+    pos = put(out, pos, size, s->name, strlen(s->name));
+    for (i = 0; i < r.nfields; i++) {
+        pos = put(out, pos, size, " ", 1);
+        pos = put(out, pos, size, s->field[i], strlen(s->field[i]));
+        pos = put(out, pos, size, "=", 1);
+        pos = put_number(out, pos, size, r.f[i]);
+    }
+    out[pos] = '\0';
+    return pos;
+}
@@ -0,0 +1,66 @@
+#ifndef LOGREC_H
+#define LOGREC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Typed calculation log records
+// A saved result is a module id, a timestamp and a fixed list of numeric
+// fields (see the schema table in logrec.c), encoded as the payload of a
+// calclog frame: a 16-byte header followed by the fields as doubles in
+// host byte order. Readers get the fields back with one memcpy instead of
+// parsing text. The first payload byte is the schema version (1), so the
+// free-text records of older logs, which start with a printable character,
+// are told apart and still printed as they are.
+
+#define LOGREC_VERSION    1
+#define LOGREC_HEADER     16
+#define LOGREC_MAX_FIELDS 6
+#define LOGREC_MAX_SIZE   (LOGREC_HEADER + 8 * LOGREC_MAX_FIELDS)
+#define LOGREC_TEXT_MAX   512     // longest line logrec_format() produces
+
+typedef enum {
+    LR_COLOR_TO_R = 1,   // b1, b2, m, t, R, tol_pct
+    LR_R_TO_COLOR,       // R, d1, d2, m
+    LR_MARKING,          // family (0 resistor, 1 inductor, 2 capacitor,
+                         // 3 EIA-96), value, tol_pct, tol_abs, tol_minus_pct
+    LR_SERIES_PARALLEL,  // n, mode (1 series, 2 parallel), total
+    LR_RC_CHARGE,        // R, C, V, t, Vc
+    LR_RC_DISCHARGE,     // R, C, V0, t, Vc
+    LR_OHM,              // V, I, R, P
+    LR_SIGNAL,           // f, T, w
+    LR_SINE,             // f, A, fs, N
+    LR_MODULE_COUNT
+} logrec_module;
+
+typedef struct {
+    uint8_t  version;               // LOGREC_VERSION
+    uint8_t  module;                // logrec_module
+    uint8_t  nfields;               // as the schema of the module (fewer in
+                                    // records older than its last field)
+    uint8_t  reserved[5];
+    int64_t  time_us;               // Unix time in microseconds
+    double   f[LOGREC_MAX_FIELDS];
+} logrec;
+
+// Fills in version, module, field count and the current time; the fields
+// themselves are set by the caller
+void logrec_init(logrec *r, logrec_module module);
+
+const char *logrec_module_name(int module);
+// Field names of a module, NULL past the last one
+const char *logrec_field_name(int module, int field);
+int logrec_field_count(int module);
+
+// Encoded size of r, at most LOGREC_MAX_SIZE
+size_t logrec_encode(const logrec *r, unsigned char *out);
+// 0 if data is a valid typed record of this schema version, -1 otherwise;
+// fields a record predates are 0
+int logrec_decode(const void *data, size_t len, logrec *r);
+
+// One line without a newline, "2026-10-17 14:03:51 ohm V=5 I=0.01 ...";
+// a payload that is not a typed record is copied as text. Returns the
+// length written (truncated to size - 1).
+size_t logrec_format(const void *data, size_t len, char *out, size_t size);
+
+#endif
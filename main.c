@@ -4,136 +4,63 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
-#include <math.h>
 #include "funcs.h"
-
-// Prototypes mirroring the C++ version 
-static void main_menu(void);            //runs in the main loop 
-static void print_main_menu(void);      //output the main menu description 
-static int  get_user_input(void);       // get a valid integer menu choice 
-static void select_menu_item(int input);// run code based on user's choice 
-static void go_back_to_main(void);      // wait for 'b'or'B' to continue 
-static int  is_integer(const char *s);  // validate integer string 
-
-int main(void)
-{
-    // this will run forever until we call exit(0) in select_menu_item() 
-    for(;;) {
-        main_menu();
-    }
-    return 0;
-}
-
-static void main_menu(void)
+#include "menu.h"
+#include "cli.h"
+#include "repl.h"
+
+static void print_usage(const char *prog);  // list options and named commands
+
+// Main menu table, add a row here to add a main menu item
+static const menu_entry_t main_entries[] = {
+    { 1, "Electrical Engineering Toolbox", "toolbox", NULL,        &toolbox_menu },
+    { 2, "Expression REPL",                "repl",    repl_run,    NULL },
+    { 3, "Menu item 3",                    NULL,      menu_item_3, NULL },
+    { 4, "Menu item 4",                    NULL,      menu_item_4, NULL },
+    { 5, "Exit",                           NULL,      NULL,        NULL },
+};
+
+static menu_t main_menu = {
+    .header  = "\n Main menu \n\n",
+    .footer  = "---------------------------------------------\n",
+    .prompt  = "\nSelect item: ",
+    .entries = main_entries,
+    .count   = sizeof(main_entries) / sizeof(main_entries[0]),
+    .flags   = MENU_PAUSE | MENU_EXIT,
+};
+
+int main(int argc, char *argv[])
 {
-    print_main_menu();
-    {
-        int input = get_user_input();
-        select_menu_item(input);
-    }
-}
-
-static int get_user_input(void)
-{
-    enum { MENU_ITEMS = 5 };  
-    char buf[128];
-    int valid_input = 0;
-    int value = 0;
-
-    do {
-        printf("\nSelect item: ");
-        if (!fgets(buf, sizeof(buf), stdin)) {
-            puts("\nInput error. Exiting.");
-            exit(1);
+    // "main.out <subcommand> ..." prints one result and exits
+    if (argc > 1 && cli_is_command(argv[1]))
+        return cli_run(argc - 1, argv + 1);
+
+    // "main.out --list" or "main.out --run <command>" for scripting
+    if (argc > 1) {
+        if (strcmp(argv[1], "--list") == 0) {
+            menu_list_commands(&main_menu, stdout);
+            return 0;
         }
-
-        // strip trailing newline
-        buf[strcspn(buf, "\r\n")] = '\0';
-
-        if (!is_integer(buf)) {
-            printf("Enter an integer!\n");
-            valid_input = 0;
-        } else {
-            value = (int)strtol(buf, NULL, 10);
-            if (value >= 1 && value <= MENU_ITEMS) {
-                valid_input = 1;
-            } else {
-                printf("Invalid menu item!\n");
-                valid_input = 0;
+        if (strcmp(argv[1], "--run") == 0 && argc == 3) {
+            if (menu_run_command(&main_menu, argv[2]) != 0) {
+                fprintf(stderr, "Unknown command: %s\n", argv[2]);
+                return 1;
             }
+            return 0;
         }
-    } while (!valid_input);
-
-    return value;
-}
-
-static void select_menu_item(int input)
-{
-    switch (input) {
-        case 1:
-            menu_item_1();
-            go_back_to_main();
-            break;
-        case 2:
-            menu_item_2();
-            go_back_to_main();
-            break;
-        case 3:
-            menu_item_3();
-            go_back_to_main();
-            break;
-        case 4:
-            menu_item_4();
-            go_back_to_main();
-            break;
-        default:
-            printf("Bye!\n");
-            exit(0);
+        print_usage(argv[0]);
+        return 1;
     }
-}
-
-static void print_main_menu(void)
-{
-    printf("\n Main menu \n");
-    printf("\n"
-           "\t\t\t\t\t\t\n"
-           "\t1. Menu item 1\t\t\n"
-           "\t2. Menu item 2\t\t\n"
-           "\t3. Menu item 3\t\t\n"
-           "\t4. Menu item 4\t\t\n"
-           "\t5. Exit\t\t\t\t\n"
-           "\t\t\t\t\t\t\n");
-    printf("---------------------------------------------\n");
-}
 
-static void go_back_to_main(void)
-{
-    char buf[64];
-    do {
-        printf("\nEnter 'b' or 'B' to go back to main menu: ");
-        if (!fgets(buf, sizeof(buf), stdin)) {
-            puts("\nInput error. Exiting.");
-            exit(1);
-        }
-        buf[strcspn(buf, "\r\n")] = '\0'; /* strip newline */
-    } while (!(buf[0] == 'b' || buf[0] == 'B') || buf[1] != '\0');
+    // runs until the user picks Exit
+    menu_run(&main_menu);
+    return 0;
 }
 
-// Return 1 if s is an optional [+/-] followed by one-or-more digits, else 0. 
-static int is_integer(const char *s)
+static void print_usage(const char *prog)
 {
-if (!s || !*s) return 0;
-
-    /* optional sign */
-    if (*s == '+' || *s == '-') s++;
-
-    // must have at least one digit 
-    if (!isdigit((unsigned char)*s)) return 0;
-
-    while (*s) {
-        if (!isdigit((unsigned char)*s)) return 0;
-        s++;
-    }
-    return 1;
+    fprintf(stderr, "Usage: %s [--list | --run <command> | <subcommand> ...]\n", prog);
+    cli_print_usage(prog);
+    fprintf(stderr, "Menu commands (for --run):\n");
+    menu_list_commands(&main_menu, stderr);
 }
@@ -0,0 +1,383 @@
+// Component marking decoder
+// Families differ only in their tables; one decoder walks a layout and
+// reads each symbol's role from the family's tables.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <math.h>
+#include "funcs.h"
+#include "eseries.h"
+#include "marking.h"
+#include "arena.h"
+#include "textio.h"
+#include "scheduler.h"
+
+#define MK_MAX_SYMBOLS 8
+#define MK_GRAIN       16384
+
+// ---- Colors ----
+
+static const char *const color_names[12] = {
+    "black", "brown", "red", "orange", "yellow",
+    "green", "blue", "violet", "grey", "white", "gold", "silver"
+};
+
+// Color index + 1 by first and last letter, which is unique for all
+// twelve names ("gray" shares grey's slot)
+#define CL(first, last) [(first) - 'a'][(last) - 'a']
+static const signed char color_by_letters[26][26] = {
+    CL('b', 'k') = 1,  CL('b', 'n') = 2,  CL('r', 'd') = 3,  CL('o', 'e') = 4,
+    CL('y', 'w') = 5,  CL('g', 'n') = 6,  CL('b', 'e') = 7,  CL('v', 't') = 8,
+    CL('g', 'y') = 9,  CL('w', 'e') = 10, CL('g', 'd') = 11, CL('s', 'r') = 12,
+};
+
+int marking_color(const char *name)
+{
+    size_t len;
+    int first, last, i;
+
+    if (!name || (len = strlen(name)) < 3) return -1;
+    first = tolower((unsigned char)name[0]);
+    last = tolower((unsigned char)name[len - 1]);
+    if (first < 'a' || first > 'z' || last < 'a' || last > 'z') return -1;
+
+    i = color_by_letters[first - 'a'][last - 'a'] - 1;
+    if (i < 0) return -1;
+    if (strcasecmp(name, color_names[i]) == 0 || (i == 8 && strcasecmp(name, "gray") == 0))
+        return i;
+    return -1;
+}
+
+const char *marking_color_name(int index)
+{
+    return (index >= 0 && index < 12) ? color_names[index] : NULL;
+}
+
+// ---- Family tables ----
+
+static const signed char color_digit[12] = {
+    MK_DIGIT(0), MK_DIGIT(1), MK_DIGIT(2), MK_DIGIT(3), MK_DIGIT(4),
+    MK_DIGIT(5), MK_DIGIT(6), MK_DIGIT(7), MK_DIGIT(8), MK_DIGIT(9), 0, 0
+};
+
+static const signed char resistor_mult[12] = {
+    MK_EXP(0), MK_EXP(1), MK_EXP(2), MK_EXP(3), MK_EXP(4), MK_EXP(5),
+    MK_EXP(6), MK_EXP(7), MK_EXP(8), MK_EXP(9), MK_EXP(-1), MK_EXP(-2)
+};
+
+static const short resistor_tol[12] = {
+    [1] = 100, [2] = 200, [5] = 50, [6] = 25, [7] = 10, [8] = 5, [10] = 500, [11] = 1000
+};
+
+// Inductors (µH) only use black..yellow, gold and silver as multipliers
+static const signed char inductor_mult[12] = {
+    MK_EXP(0), MK_EXP(1), MK_EXP(2), MK_EXP(3), MK_EXP(4),
+    [10] = MK_EXP(-1), [11] = MK_EXP(-2)
+};
+
+static const short inductor_tol[12] = {
+    [0] = 2000, [1] = 100, [2] = 200, [3] = 300, [4] = 400, [10] = 500, [11] = 1000
+};
+
+static const signed char char_digit[128] = {
+    ['0'] = MK_DIGIT(0), ['1'] = MK_DIGIT(1), ['2'] = MK_DIGIT(2), ['3'] = MK_DIGIT(3),
+    ['4'] = MK_DIGIT(4), ['5'] = MK_DIGIT(5), ['6'] = MK_DIGIT(6), ['7'] = MK_DIGIT(7),
+    ['8'] = MK_DIGIT(8), ['9'] = MK_DIGIT(9),
+};
+
+// Temperature coefficient band of 6-band resistors (ppm/K), black..grey
+static const short resistor_tempco[12] = {
+    250, 100, 50, 15, 25, 20, 10, 5, 1
+};
+
+// Ceramic capacitors (pF): third digit 0-6 is 10^n, 8 and 9 are 0.01 and 0.1
+static const signed char capacitor_mult[128] = {
+    ['0'] = MK_EXP(0), ['1'] = MK_EXP(1), ['2'] = MK_EXP(2), ['3'] = MK_EXP(3),
+    ['4'] = MK_EXP(4), ['5'] = MK_EXP(5), ['6'] = MK_EXP(6),
+    ['8'] = MK_EXP(-2), ['9'] = MK_EXP(-1),
+};
+
+// B/C/D are absolute (±0.1/0.25/0.5 pF); Z is +80/-20%
+static const short capacitor_tol[128] = {
+    ['B'] = -10, ['C'] = -25, ['D'] = -50, ['F'] = 100, ['G'] = 200,
+    ['J'] = 500, ['K'] = 1000, ['M'] = 2000, ['Z'] = 8000,
+};
+
+static const short capacitor_tol_minus[128] = {
+    ['Z'] = 2000,
+};
+
+// EIA-96 multiplier letters
+static const signed char eia96_mult[128] = {
+    ['Z'] = MK_EXP(-3), ['Y'] = MK_EXP(-2), ['R'] = MK_EXP(-2), ['X'] = MK_EXP(-1),
+    ['S'] = MK_EXP(-1), ['A'] = MK_EXP(0),  ['B'] = MK_EXP(1),  ['H'] = MK_EXP(1),
+    ['C'] = MK_EXP(2),  ['D'] = MK_EXP(3),  ['E'] = MK_EXP(4),  ['F'] = MK_EXP(5),
+};
+
+const marking_family mk_resistor = {
+    .name = "resistor", .unit = "ohm", .example = "yellow violet red gold", .chars = 0,
+    .layouts = { "DDM", "DDMT", "DDDMT", "DDDMTP" },
+    .digit = color_digit, .mult = resistor_mult, .tol = resistor_tol, .tol_default = 2000,
+    .tempco = resistor_tempco,
+};
+
+const marking_family mk_inductor = {
+    .name = "inductor", .unit = "uH", .example = "brown black red silver", .chars = 0,
+    .layouts = { "DDM", "DDMT" },
+    .digit = color_digit, .mult = inductor_mult, .tol = inductor_tol, .tol_default = 2000,
+};
+
+const marking_family mk_capacitor = {
+    .name = "capacitor", .unit = "pF", .example = "104K", .chars = 1,
+    .layouts = { "DD", "DDM", "DDMT" },
+    .digit = char_digit, .mult = capacitor_mult, .tol = capacitor_tol,
+    .tol_minus = capacitor_tol_minus, .tol_default = 0,
+};
+
+const marking_family mk_eia96 = {
+    .name = "eia96", .unit = "ohm", .example = "01C", .chars = 1,
+    .layouts = { "EM" },
+    .digit = char_digit, .mult = eia96_mult, .tol_default = 100,
+};
+
+static const marking_family *const families[] = {
+    &mk_resistor, &mk_inductor, &mk_capacitor, &mk_eia96,
+};
+
+#define FAMILY_COUNT (int)(sizeof(families) / sizeof(families[0]))
+
+const marking_family *marking_find(const char *name)
+{
+    int i;
+    for (i = 0; i < FAMILY_COUNT; i++)
+        if (strcmp(families[i]->name, name) == 0) return families[i];
+    return NULL;
+}
+
+void marking_list(FILE *out)
+{
+    int i;
+    for (i = 0; i < FAMILY_COUNT; i++)
+        fprintf(out, "  %-10s %-4s e.g. \"%s\"\n", families[i]->name, families[i]->unit,
+                families[i]->example);
+}
+
+// ---- Decoding ----
+
+double marking_multiplier(const marking_family *f, int symbol)
+{
+    int e;
+
+    if (symbol < 0 || symbol >= (f->chars ? 128 : 12) || !(e = f->mult[symbol])) return -1;
+    return POW10(e - MK_EXP(0));
+}
+
+static void mk_set_tol(marking_result *out, int tol, int minus)
+{
+    out->tol_pct = (tol > 0) ? tol / 100.0 : 0.0;
+    out->tol_abs = (tol < 0) ? -tol / 100.0 : 0.0;
+    out->tol_minus_pct = minus ? minus / 100.0 : out->tol_pct;
+}
+
+// Decodes with one layout, -1 if a symbol does not fit its role
+static int mk_layout(const marking_family *f, const char *layout,
+                     const unsigned char code[], marking_result *out)
+{
+    long mantissa = 0;
+    int exp10 = 0, tol = f->tol_default, minus = 0, tempco = 0, k = 0, d, e;
+
+    for (; *layout; layout++) {
+        switch (*layout) {
+        case 'D':
+            if (!(d = f->digit[code[k++]])) return -1;
+            mantissa = mantissa * 10 + (d - 1);
+            break;
+        case 'E':
+            if (!(d = f->digit[code[k]]) || !(e = f->digit[code[k + 1]])) return -1;
+            d = (d - 1) * 10 + (e - 1);
+            if (d < 1 || d > 96) return -1;
+            mantissa = e96_values[d - 1];
+            k += 2;
+            break;
+        case 'M':
+            if (!(e = f->mult[code[k++]])) return -1;
+            exp10 = e - MK_EXP(0);
+            break;
+        case 'T':
+            if (!f->tol || !(tol = f->tol[code[k]])) return -1;
+            if (f->tol_minus) minus = f->tol_minus[code[k]];
+            k++;
+            break;
+        case 'P':
+            if (!f->tempco || !(tempco = f->tempco[code[k++]])) return -1;
+            break;
+        }
+    }
+    out->value = mantissa * POW10(exp10);
+    out->tempco_ppm = tempco;
+    mk_set_tol(out, tol, minus);
+    return 0;
+}
+
+int marking_decode_codes(const marking_family *f, const unsigned char code[], int n,
+                         marking_result *out)
+{
+    int i, symbols, nsym = f->chars ? 128 : 12;
+    const char *l;
+
+    for (i = 0; i < n; i++)
+        if (code[i] >= nsym) { out->value = -1.0; return -1; }
+    for (i = 0; i < 4 && f->layouts[i]; i++) {
+        for (symbols = 0, l = f->layouts[i]; *l; l++) symbols += (*l == 'E') ? 2 : 1;
+        if (symbols == n && mk_layout(f, f->layouts[i], code, out) == 0) return 0;
+    }
+    out->value = -1.0;
+    return -1;
+}
+
+// Text to symbol codes, returns the symbol count or -1
+static int mk_symbols(const marking_family *f, const char *text, unsigned char code[])
+{
+    int n = 0;
+
+    if (f->chars) {
+        for (; *text; text++) {
+            unsigned char c = (unsigned char)toupper((unsigned char)*text);
+            if (isspace(c)) continue;
+            if (c >= 128 || n == MK_MAX_SYMBOLS) return -1;
+            code[n++] = c;
+        }
+        return n;
+    }
+
+    // color names separated by spaces, commas or dashes
+    while (*text) {
+        char name[16];
+        size_t len = strcspn(text, " \t,-\r\n");
+        int c;
+
+        if (len == 0) { text++; continue; }
+        if (len >= sizeof(name) || n == MK_MAX_SYMBOLS) return -1;
+        memcpy(name, text, len);
+        name[len] = '\0';
+        if ((c = marking_color(name)) < 0) return -1;
+        code[n++] = (unsigned char)c;
+        text += len;
+    }
+    return n;
+}
+
+int marking_decode(const marking_family *f, const char *text, marking_result *out)
+{
+    unsigned char code[MK_MAX_SYMBOLS];
+    int n = mk_symbols(f, text, code);
+
+    if (n <= 0) {
+        out->value = -1.0;
+        return -1;
+    }
+    return marking_decode_codes(f, code, n, out);
+}
+
+int marking_decode_batch(const marking_family *f, const char *const text[], int n,
+                         marking_result out[])
+{
+    int i, bad = 0;
+    for (i = 0; i < n; i++) bad += (marking_decode(f, text[i], &out[i]) != 0);
+    return bad;
+}
+
+// ---- Command ----
+
+typedef struct {
+    const marking_family *f;
+    const char *const    *text;
+    marking_result       *out;
+} mk_job;
+
+static void mk_chunk(size_t lo, size_t hi, void *arg)
+{
+    const mk_job *j = arg;
+    marking_decode_batch(j->f, j->text + lo, (int)(hi - lo), j->out + lo);
+}
+
+static void mk_usage(void)
+{
+    fprintf(stderr, "Usage: main.out marking <family> <code>...\n"
+                    "       main.out marking <family> --file codes.txt [-o out.csv]\n"
+                    "Families:\n");
+    marking_list(stderr);
+}
+
+int marking_main(int argc, char *argv[])
+{
+    const marking_family *f;
+    const char *in_path = NULL, *out_path = NULL;
+    const char **text;
+    marking_result *res;
+    textio_out out;
+    FILE *fp = stdout;
+    mk_job job;
+    int i, n = 0, bad;
+
+    if (argc < 3 || !(f = marking_find(argv[1]))) { mk_usage(); return 1; }
+
+    text = arena_alloc(&request_arena, sizeof(char *) * argc);
+    if (!text) return 1;
+    for (i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--file") == 0 && i + 1 < argc) in_path = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) out_path = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) sched_set_threads(atoi(argv[++i]));
+        else text[n++] = argv[i];
+    }
+
+    if (in_path) {
+        size_t len;
+        char *data = textio_read_file(&request_arena, in_path, &len);
+        size_t max = len / 2 + 1;
+
+        if (!data || !(text = arena_alloc(&request_arena, sizeof(char *) * max))) {
+            fprintf(stderr, "marking: cannot read '%s'\n", in_path);
+            return 1;
+        }
+        n = textio_split_lines(data, len, text, (int)max);
+    }
+
+    res = arena_alloc(&request_arena, sizeof(marking_result) * (n + 1));
+    if (!res) {
+        fprintf(stderr, "marking: out of memory\n");
+        return 1;
+    }
+    job.f = f;
+    job.text = text;
+    job.out = res;
+    parallel_for(0, (size_t)n, MK_GRAIN, mk_chunk, &job);
+
+    if (out_path && !(fp = fopen(out_path, "w"))) {
+        fprintf(stderr, "marking: cannot write '%s'\n", out_path);
+        return 1;
+    }
+    textio_out_open(&out, fp);
+    for (bad = 0, i = 0; i < n; i++) {
+        if (res[i].value < 0) {
+            textio_printf(&out, "%s,invalid\n", text[i]);
+            bad++;
+            continue;
+        }
+        textio_printf(&out, "%s,%.6g,%s", text[i], res[i].value, f->unit);
+        if (res[i].tol_abs > 0) textio_printf(&out, ",±%g %s", res[i].tol_abs, f->unit);
+        else if (res[i].tol_minus_pct != res[i].tol_pct)
+            textio_printf(&out, ",+%g/-%g%%", res[i].tol_pct, res[i].tol_minus_pct);
+        else if (res[i].tol_pct > 0) textio_printf(&out, ",±%g%%", res[i].tol_pct);
+        if (res[i].tempco_ppm > 0) textio_printf(&out, ",%g ppm/K", res[i].tempco_ppm);
+        textio_write(&out, "\n", 1);
+    }
+    textio_out_close(&out);
+    if (fp != stdout) fclose(fp);
+
+    arena_reset(&request_arena);
+    return bad ? 1 : 0;
+}
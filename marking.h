@@ -0,0 +1,69 @@
+#ifndef MARKING_H
+#define MARKING_H
+
+#include <stdio.h>
+
+// Component marking decoder
+// Every code family (resistor and inductor color bands, ceramic capacitor
+// digits, SMD EIA-96) is one table-driven marking_family: a list of
+// layouts such as "DDMT" and per-symbol tables giving each symbol's
+// digit, multiplier exponent and tolerance. Decoding a symbol is one
+// table read; color names are found through a packed first/last letter
+// table.
+
+// Table entries are biased so that 0 (the default for characters that
+// are not listed) always means "not allowed here"
+#define MK_DIGIT(d) ((d) + 1)
+#define MK_EXP(e)   ((e) + 16)
+
+typedef struct {
+    const char        *name;        // "resistor", "capacitor", ...
+    const char        *unit;        // unit of the decoded value
+    const char        *example;
+    int                chars;       // 1: symbols are characters, 0: color names
+    const char        *layouts[4];  // D digit, M multiplier, T tolerance, P tempco, E EIA-96 code (2 symbols)
+    const signed char *digit;       // symbol → MK_DIGIT(0..9)
+    const signed char *mult;        // symbol → MK_EXP(decimal exponent)
+    const short       *tol;         // symbol → tolerance in 1/100 %, negative = ±1/100 unit, 0 = none
+    const short       *tol_minus;   // symbol → minus side in 1/100 % where it differs (NULL = all symmetric)
+    short              tol_default; // when the layout has no tolerance symbol
+    const short       *tempco;      // symbol → ppm/K, 0 = none (NULL if the family has no tempco band)
+} marking_family;
+
+typedef struct {
+    double value;      // in family->unit
+    double tol_pct;    // tolerance in percent (plus side), 0 if given in units
+    double tol_minus_pct; // minus side in percent, = tol_pct unless asymmetric (Z: +80/-20)
+    double tol_abs;    // tolerance in units (capacitor letters B/C/D), else 0
+    double tempco_ppm; // temperature coefficient band (6-band resistors), else 0
+} marking_result;
+
+extern const marking_family mk_resistor, mk_inductor, mk_capacitor, mk_eia96;
+
+const marking_family *marking_find(const char *name);
+
+// Multiplier of a symbol (10^exponent), -1 if it is not a multiplier
+double marking_multiplier(const marking_family *f, int symbol);
+void marking_list(FILE *out);
+
+// Color index (0 black .. 9 white, 10 gold, 11 silver) of a name, -1 if none
+int marking_color(const char *name);
+const char *marking_color_name(int index);
+
+// Decodes one marking: color names separated by spaces, commas or dashes
+// ("yellow violet red gold") or the printed characters ("104K", "01C")
+// Returns 0 on success, -1 if it is not a valid code of the family
+int marking_decode(const marking_family *f, const char *text, marking_result *out);
+
+// Same on symbol codes (color indices or characters)
+int marking_decode_codes(const marking_family *f, const unsigned char code[], int n,
+                         marking_result *out);
+
+// Decodes n markings, invalid ones get value -1; returns the invalid count
+int marking_decode_batch(const marking_family *f, const char *const text[], int n,
+                         marking_result out[]);
+
+// "main.out marking <family> <code>... | --file list.txt"
+int marking_main(int argc, char *argv[]);
+
+#endif
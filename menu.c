@@ -0,0 +1,181 @@
+// Table-driven menu engine
+// Builds each menu's text once into a cached buffer and dispatches choices
+// through the entry table instead of a hand-written switch.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "menu.h"
+#include "arena.h"
+
+// Builds the cached menu text and the valid key range
+static void menu_build(menu_t *m)
+{
+    int i, len = 0;
+
+    len += snprintf(m->text + len, sizeof(m->text) - len, "%s", m->header);
+
+    m->min_key = m->max_key = m->entries[0].key;
+    for (i = 0; i < m->count && len < (int)sizeof(m->text); i++) {
+        const menu_entry_t *e = &m->entries[i];
+        len += snprintf(m->text + len, sizeof(m->text) - len,
+                        "%d. %s\n", e->key, e->label);
+        if (e->key < m->min_key) m->min_key = e->key;
+        if (e->key > m->max_key) m->max_key = e->key;
+    }
+
+    if (m->footer && len < (int)sizeof(m->text))
+        len += snprintf(m->text + len, sizeof(m->text) - len, "%s", m->footer);
+
+    // snprintf reports the untruncated length, clamp to what was stored
+    if (len >= (int)sizeof(m->text)) len = (int)sizeof(m->text) - 1;
+    m->text_len = len;
+}
+
+// Menu text, prompts and the pause line are only for a terminal. With
+// stdin from a file or pipe they are left out, so scripted sessions print
+// just the results; TOOLBOX_MENU=1 shows them anyway.
+static int menu_shown(void)
+{
+    static int shown = -1;
+
+    if (shown < 0) {
+        const char *env = getenv("TOOLBOX_MENU");
+        shown = (env && env[0] == '1') || isatty(STDIN_FILENO);
+    }
+    return shown;
+}
+
+// Reads a menu choice in [min, max], asking again until valid
+static int menu_read_choice(const char *prompt, int min, int max)
+{
+    char buf[64], *endptr;
+    long val;
+
+    for (;;) {
+        if (menu_shown()) fputs(prompt, stdout);
+
+        if (!fgets(buf, sizeof(buf), stdin)) {
+            printf("\nInput error. Exiting.\n");
+            exit(1);
+        }
+
+        val = strtol(buf, &endptr, 10);
+
+        if (endptr == buf) {
+            printf("Enter an integer!\n");
+            continue;
+        }
+
+        while (*endptr == ' ' || *endptr == '\t') endptr++;
+
+        if (*endptr != '\n' && *endptr != '\0') {
+            printf("Enter an integer!\n");
+            continue;
+        }
+
+        if (val < min || val > max) {
+            printf("Invalid menu item!\n");
+            continue;
+        }
+
+        return (int)val;
+    }
+}
+
+// Wait for 'b' or 'B' before showing the menu again
+static void menu_pause(void)
+{
+    char buf[64];
+    do {
+        if (menu_shown()) printf("\nEnter 'b' or 'B' to go back to main menu: ");
+        if (!fgets(buf, sizeof(buf), stdin)) {
+            puts("\nInput error. Exiting.");
+            exit(1);
+        }
+        buf[strcspn(buf, "\r\n")] = '\0';
+    } while (!(buf[0] == 'b' || buf[0] == 'B') || buf[1] != '\0');
+}
+
+static const menu_entry_t *menu_entry_for_key(const menu_t *m, int key)
+{
+    int i;
+    for (i = 0; i < m->count; i++)
+        if (m->entries[i].key == key) return &m->entries[i];
+    return NULL;
+}
+
+// Runs one entry, returns 0 if it was the back/exit entry
+// Scratch memory used by an action is released when it returns
+static int menu_dispatch(const menu_entry_t *e)
+{
+    if (e->submenu) {
+        menu_run(e->submenu);
+    } else if (e->handler) {
+        e->handler();
+        arena_reset(&request_arena);
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+void menu_run(menu_t *m)
+{
+    for (;;) {
+        const menu_entry_t *e;
+
+        if (m->text_len == 0) menu_build(m);
+        if (menu_shown()) fwrite(m->text, 1, (size_t)m->text_len, stdout);
+
+        e = menu_entry_for_key(m, menu_read_choice(m->prompt, m->min_key, m->max_key));
+        if (!e) {
+            printf("Invalid menu item!\n");
+            continue;
+        }
+
+        if (!menu_dispatch(e)) {
+            if (m->flags & MENU_EXIT) {
+                if (menu_shown()) printf("Bye!\n");
+                exit(0);
+            }
+            return;
+        }
+
+        if (m->flags & MENU_PAUSE) menu_pause();
+    }
+}
+
+const menu_entry_t *menu_find_command(const menu_t *root, const char *command)
+{
+    int i;
+
+    for (i = 0; i < root->count; i++) {
+        const menu_entry_t *e = &root->entries[i];
+        if (e->command && strcmp(e->command, command) == 0) return e;
+        if (e->submenu) {
+            const menu_entry_t *found = menu_find_command(e->submenu, command);
+            if (found) return found;
+        }
+    }
+    return NULL;
+}
+
+int menu_run_command(const menu_t *root, const char *command)
+{
+    const menu_entry_t *e = menu_find_command(root, command);
+    if (!e || !menu_dispatch(e)) return -1;
+    return 0;
+}
+
+void menu_list_commands(const menu_t *root, FILE *out)
+{
+    int i;
+
+    for (i = 0; i < root->count; i++) {
+        const menu_entry_t *e = &root->entries[i];
+        if (e->command) fprintf(out, "  %-18s %s\n", e->command, e->label);
+        if (e->submenu) menu_list_commands(e->submenu, out);
+    }
+}
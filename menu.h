@@ -0,0 +1,50 @@
+#ifndef MENU_H
+#define MENU_H
+
+#include <stdio.h>
+
+// Table-driven menus
+// Each menu is a static table of entries. menu_run() prints the menu and
+// dispatches the user's choice, so adding a module only needs one new row.
+// The menu text and prompts are printed only when stdin is a terminal (or
+// TOOLBOX_MENU=1), so answers piped in from a script give just the results.
+
+#define MENU_TEXT_SIZE 1024
+
+// Menu flags
+#define MENU_PAUSE   1   // wait for 'b' after each item (main menu style)
+#define MENU_EXIT    2   // the back entry exits the program ("Bye!")
+
+typedef struct menu menu_t;
+
+typedef struct {
+    int         key;             // number the user types
+    const char *label;           // text shown next to the number
+    const char *command;         // name for scripting/batch (NULL = hidden)
+    void      (*handler)(void);  // action to run
+    menu_t     *submenu;         // nested menu to run instead of handler
+} menu_entry_t;                  // handler and submenu both NULL = back/exit
+
+struct menu {
+    const char         *header;  // printed above the entries
+    const char         *footer;  // printed below the entries (may be NULL)
+    const char         *prompt;  // input prompt
+    const menu_entry_t *entries;
+    int                 count;
+    int                 flags;
+
+    // Built once on first display, then reused
+    char                text[MENU_TEXT_SIZE];
+    int                 text_len;
+    int                 min_key, max_key;
+};
+
+// Runs a menu until its back/exit entry is chosen
+void menu_run(menu_t *m);
+
+// Named commands (searches the menu and all of its submenus)
+const menu_entry_t *menu_find_command(const menu_t *root, const char *command);
+int  menu_run_command(const menu_t *root, const char *command);
+void menu_list_commands(const menu_t *root, FILE *out);
+
+#endif
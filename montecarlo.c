@@ -0,0 +1,68 @@
+// Tolerance Monte Carlo
+// The per-sample work allocates nothing: each resistor value is drawn
+// straight from the counter-based generator and folded into the total.
+
+#include <math.h>
+#include "montecarlo.h"
+#include "rng.h"
+
+#define MC_PI 3.14159265358979323846
+
+static double mc_sample(const mc_network *net, uint64_t i)
+{
+    double total = 0.0, u[2];
+    int j;
+
+    for (j = 0; j < net->n; j++) {
+        double dev, r;
+
+        if (net->normal) {
+            dev = rng_normal(net->seed, i, (uint32_t)j) * net->tol / 3.0;
+        } else {
+            rng_uniform2(net->seed, i, (uint32_t)j, u);
+            dev = (2.0 * u[0] - 1.0) * net->tol;
+        }
+        r = net->R[j] * (1.0 + dev);
+        total += net->parallel ? 1.0 / r : r;
+    }
+    return net->parallel ? 1.0 / total : total;
+}
+
+static void mc_leaf(size_t lo, size_t hi, void *ctx, reduce_stats *st)
+{
+    const mc_network *net = ctx;
+    size_t i;
+
+    for (i = lo; i < hi; i++) reduce_add(st, mc_sample(net, (uint64_t)i));
+}
+
+void mc_run(const mc_network *net, size_t N, reduce_stats *st)
+{
+    parallel_reduce(N, mc_leaf, (void *)net, st);
+}
+
+// R and C are draws 0 and 1 of sample i (one Philox block when uniform)
+static void mc_rc_leaf(size_t lo, size_t hi, void *ctx, reduce_stats *st)
+{
+    const mc_rc *rc = ctx;
+    double u[2], dr, dc, tau;
+    size_t i;
+
+    for (i = lo; i < hi; i++) {
+        if (rc->normal) {
+            dr = rng_normal(rc->seed, (uint64_t)i, 0) * rc->rtol / 3.0;
+            dc = rng_normal(rc->seed, (uint64_t)i, 1) * rc->ctol / 3.0;
+        } else {
+            rng_uniform2(rc->seed, (uint64_t)i, 0, u);
+            dr = (2.0 * u[0] - 1.0) * rc->rtol;
+            dc = (2.0 * u[1] - 1.0) * rc->ctol;
+        }
+        tau = rc->R * (1.0 + dr) * rc->C * (1.0 + dc);
+        reduce_add(st, rc->cutoff ? 1.0 / (2.0 * MC_PI * tau) : tau);
+    }
+}
+
+void mc_rc_run(const mc_rc *rc, size_t N, reduce_stats *st)
+{
+    parallel_reduce(N, mc_rc_leaf, (void *)rc, st);
+}
@@ -0,0 +1,37 @@
+#ifndef MONTECARLO_H
+#define MONTECARLO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "reduce.h"
+
+// Tolerance Monte Carlo of a series or parallel resistor network
+// Sample i draws resistor j from Philox counter (i, j), so the samples
+// (and with deterministic reductions, the statistics) do not depend on
+// the thread count or scheduling.
+
+typedef struct {
+    const double *R;        // nominal values
+    int           n;
+    int           parallel; // 0 = series, 1 = parallel
+    double        tol;      // tolerance as a fraction (0.05 = 5%)
+    int           normal;   // 0 = uniform in +-tol, 1 = normal with sigma = tol/3
+    uint64_t      seed;
+} mc_network;
+
+// Runs N samples, fills *st with the totals' sum/sumsq/min/max
+void mc_run(const mc_network *net, size_t N, reduce_stats *st);
+
+// Time constant R*C with independent resistor and capacitor tolerances,
+// or with cutoff set the cutoff frequency 1/(2 pi R C) of the same draws
+typedef struct {
+    double   R, C;
+    double   rtol, ctol;    // fractions, as mc_network.tol
+    int      normal;
+    uint64_t seed;
+    int      cutoff;
+} mc_rc;
+
+void mc_rc_run(const mc_rc *rc, size_t N, reduce_stats *st);
+
+#endif
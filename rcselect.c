@@ -0,0 +1,204 @@
+// RC component selector
+// Resistor values are kept as a sorted array of their logarithms. For each
+// capacitor the ideal resistor is log(tau) - log(C), so one binary search
+// lands on it and only the neighbours inside the tolerance window are
+// visited: O(nC log nR) for the whole search.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "funcs.h"
+#include "arena.h"
+#include "eseries.h"
+#include "inventory.h"
+#include "montecarlo.h"
+#include "rcselect.h"
+
+#define RC_MAX_VALUES 4096
+#define RC_MAX_TOP    100
+#define RC_PI         3.14159265358979323846
+
+// Smaller error; errors equal up to rounding (1n * 1M vs 10n * 100k) keep
+// the earlier, smaller capacitor
+#define RC_BETTER(x, y) (fabs((x)->err) < fabs((y)->err) - 1e-12)
+
+// First index with a[i] >= x
+static int log_lower_bound(const double *a, int n, double x)
+{
+    int lo = 0, hi = n;
+
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (a[mid] < x) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+int rc_select(const rc_spec *s, rc_pick out[], int top)
+{
+    arena_mark_t mark = arena_mark(&request_arena);
+    double *R = arena_alloc(&request_arena, sizeof(double) * RC_MAX_VALUES);
+    double *C = arena_alloc(&request_arena, sizeof(double) * RC_MAX_VALUES);
+    double *logR = arena_alloc(&request_arena, sizeof(double) * RC_MAX_VALUES);
+    double log_tau, window;
+    int nr, nc, i, j, found = 0;
+
+    if (!R || !C || !logR) {
+        arena_release(&request_arena, mark);
+        return -1;
+    }
+    if (!(s->tau > 0) || !(s->tol >= 0) || top < 1 ||
+        eseries_mantissas(s->rseries, NULL) < 0 || eseries_mantissas(s->cseries, NULL) < 0) {
+        arena_release(&request_arena, mark);
+        return -1;
+    }
+
+    nr = eseries_range(s->rseries, s->rmin, s->rmax, R, RC_MAX_VALUES);
+    if (s->stock) {
+        for (i = j = 0; i < nr; i++)
+            if (inv_find(s->stock, R[i], 1e-6, INV_ANY_PACKAGE, 1) >= 0) R[j++] = R[i];
+        nr = j;
+    }
+    for (i = 0; i < nr; i++) logR[i] = log(R[i]);
+
+    // capacitor values in farads: the series table works in any unit, so
+    // take them in pF (the 0.1 floor of eseries_range is far below 1 pF)
+    nc = eseries_range(s->cseries, s->cmin * 1e12, s->cmax * 1e12, C, RC_MAX_VALUES);
+
+    // |R C / tau - 1| <= tol and |tau / (R C) - 1| <= tol both keep
+    // log(R C / tau) within -log(1 - tol), the exact check follows
+    log_tau = log(s->tau);
+    window = (s->tol < 1) ? -log(1 - s->tol) : INFINITY;
+    for (j = 0; j < nc; j++) {
+        double c = C[j] * 1e-12, want = log_tau - log(c);
+
+        for (i = log_lower_bound(logR, nr, want - window); i < nr && logR[i] <= want + window; i++) {
+            rc_pick p;
+            int pos;
+
+            p.R = R[i];
+            p.C = c;
+            p.err = s->cutoff ? s->tau / (R[i] * c) - 1 : R[i] * c / s->tau - 1;
+            if (fabs(p.err) > s->tol) continue;
+
+            if (found == top && !RC_BETTER(&p, &out[top - 1])) continue;
+            pos = (found < top) ? found++ : top - 1;
+            while (pos > 0 && RC_BETTER(&p, &out[pos - 1])) {
+                out[pos] = out[pos - 1];
+                pos--;
+            }
+            out[pos] = p;
+        }
+    }
+
+    arena_release(&request_arena, mark);
+    return found;
+}
+
+// ---- Command line ----
+
+static void rc_usage(void)
+{
+    fprintf(stderr, "Usage: main.out rcselect --tau 1m | --fc 1k [--tol 2] [--rseries E24] [--cseries E12]\n"
+                    "                         [--rmin 100] [--rmax 1M] [--cmin 10p] [--cmax 100u]\n"
+                    "                         [--rtol 1] [--ctol 10] [--top 5] [--N 10k] [--seed 1]\n"
+                    "                         [--normal] [--stock parts.db]\n");
+}
+
+int rcselect_main(int argc, char *argv[])
+{
+    const char *stock_path = NULL;
+    double tau = 0, fc = 0, target, tol = 2, rtol = 1, ctol = 10, top = 5, N = 10000, seed = 1;
+    rc_spec s = { 0 };
+    rc_pick *res;
+    inventory db;
+    int i, n, normal = 0;
+
+    s.rseries = 24;
+    s.cseries = 12;
+    s.rmin = 100;
+    s.rmax = 1e6;
+    s.cmin = 10e-12;
+    s.cmax = 100e-6;
+    for (i = 1; i < argc; i++) {
+        double *opt = strcmp(argv[i], "--tau") == 0 ? &tau :
+                      strcmp(argv[i], "--fc") == 0 ? &fc :
+                      strcmp(argv[i], "--tol") == 0 ? &tol :
+                      strcmp(argv[i], "--rmin") == 0 ? &s.rmin :
+                      strcmp(argv[i], "--rmax") == 0 ? &s.rmax :
+                      strcmp(argv[i], "--cmin") == 0 ? &s.cmin :
+                      strcmp(argv[i], "--cmax") == 0 ? &s.cmax :
+                      strcmp(argv[i], "--rtol") == 0 ? &rtol :
+                      strcmp(argv[i], "--ctol") == 0 ? &ctol :
+                      strcmp(argv[i], "--top") == 0 ? &top :
+                      strcmp(argv[i], "--N") == 0 ? &N :
+                      strcmp(argv[i], "--seed") == 0 ? &seed : NULL;
+
+        if (strcmp(argv[i], "--normal") == 0) {
+            normal = 1;
+        } else if ((strcmp(argv[i], "--rseries") == 0 || strcmp(argv[i], "--cseries") == 0) && i + 1 < argc) {
+            int *series = (argv[i][2] == 'r') ? &s.rseries : &s.cseries;
+            if ((*series = eseries_parse(argv[++i])) < 0) { rc_usage(); return 1; }
+        } else if (strcmp(argv[i], "--stock") == 0 && i + 1 < argc) {
+            stock_path = argv[++i];
+        } else if (!opt || i + 1 >= argc || parse_si_value(argv[++i], opt) != 0) {
+            rc_usage();
+            return 1;
+        }
+    }
+    s.tau = (fc > 0) ? 1 / (2 * RC_PI * fc) : tau;
+    s.cutoff = fc > 0;
+    s.tol = tol / 100;
+    if (!(s.tau > 0) || tol < 0 || rtol < 0 || ctol < 0 || top < 1 || top > RC_MAX_TOP ||
+        N < 0 || N > 1e9) {
+        rc_usage();
+        return 1;
+    }
+
+    if (stock_path) {
+        if (inv_open(&db, stock_path) != 0) {
+            fprintf(stderr, "rcselect: cannot open inventory '%s'\n", stock_path);
+            return 1;
+        }
+        s.stock = &db;
+    }
+    res = arena_alloc(&request_arena, sizeof(rc_pick) * (size_t)top);
+    n = res ? rc_select(&s, res, (int)top) : -1;
+    if (s.stock) inv_close(&db);
+    if (n < 0) {
+        fprintf(stderr, "rcselect: out of memory\n");
+        return 1;
+    }
+    if (n == 0) {
+        fprintf(stderr, "rcselect: no E%d/E%d pair within %g%%\n", s.rseries, s.cseries, tol);
+        arena_reset(&request_arena);
+        return 1;
+    }
+
+    // error and spread of every pick, as percent of the target (with --fc
+    // the cutoff frequency)
+    target = (fc > 0) ? fc : s.tau;
+    printf("rank,R,C,%s,error%%,mc_mean%%,mc_sigma%%,mc_min%%,mc_max%%\n", fc > 0 ? "fc" : "tau");
+    for (i = 0; i < n; i++) {
+        mc_rc mc = { res[i].R, res[i].C, rtol / 100, ctol / 100, normal, (uint64_t)seed, fc > 0 };
+        double tau_i = res[i].R * res[i].C, mean = 0, sd = 0;
+
+        reduce_init(&res[i].mc);
+        if (N >= 1) {
+            mc_rc_run(&mc, (size_t)N, &res[i].mc);
+            mean = res[i].mc.sum / res[i].mc.n;
+            sd = sqrt(fmax(res[i].mc.sumsq / res[i].mc.n - mean * mean, 0));
+        }
+        printf("%d,%.6g,%.6g,%.6g,%+.3f", i + 1, res[i].R, res[i].C,
+               fc > 0 ? 1 / (2 * RC_PI * tau_i) : tau_i, res[i].err * 100);
+        if (N >= 1)
+            printf(",%+.3f,%.3f,%+.3f,%+.3f\n", (mean / target - 1) * 100, sd / target * 100,
+                   (res[i].mc.min / target - 1) * 100, (res[i].mc.max / target - 1) * 100);
+        else
+            printf(",,,,\n");
+    }
+    arena_reset(&request_arena);
+    return 0;
+}
@@ -0,0 +1,37 @@
+#ifndef RCSELECT_H
+#define RCSELECT_H
+
+#include "reduce.h"
+#include "inventory.h"
+
+// RC component selector
+// Searches E-series resistor and capacitor values for pairs whose R*C is
+// within a tolerance of a target time constant (or of 1/(2 pi fc) for a
+// cutoff frequency), ranks them by error and gives each of the best a
+// Monte Carlo spread of the time constant over the part tolerances.
+//
+// "main.out rcselect --tau 1m | --fc 1k [--tol 2] [--rseries E24] [--cseries E12]
+//  [--rmin 100] [--rmax 1M] [--cmin 10p] [--cmax 100u] [--rtol 1] [--ctol 10]
+//  [--top 5] [--N 10k] [--seed 1] [--normal] [--stock parts.db]"
+
+typedef struct {
+    double tau;                // target R*C in seconds
+    double tol;                // accepted relative error (0.02 = 2%)
+    int    cutoff;             // 1: tol and err are of the cutoff frequency 1/(2 pi R C)
+    int    rseries, cseries;   // E-series of each part
+    double rmin, rmax, cmin, cmax;
+    const inventory *stock;    // only resistors in stock, NULL = any
+} rc_spec;
+
+typedef struct {
+    double R, C, err;          // err = R*C / tau - 1, with cutoff tau / (R*C) - 1
+    reduce_stats mc;           // Monte Carlo time constants, or cutoff frequencies (filled by the caller)
+} rc_pick;
+
+// Best `top` pairs by |err|, best first; returns how many were found or
+// -1 if the spec is invalid or memory ran out
+int rc_select(const rc_spec *s, rc_pick out[], int top);
+
+int rcselect_main(int argc, char *argv[]);
+
+#endif
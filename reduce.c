@@ -0,0 +1,158 @@
+// Parallel reductions
+// Deterministic mode stores one partial per fixed chunk (from the request
+// arena) and combines them pairwise: ((p0+p1)+(p2+p3))+... in chunk order.
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "reduce.h"
+#include "scheduler.h"
+#include "arena.h"
+
+#define REDUCE_MAX_WORKERS 256
+
+static int deterministic = -1;   // -1 = not set, read the environment
+
+void reduce_set_deterministic(int on)
+{
+    deterministic = on;
+}
+
+int reduce_deterministic(void)
+{
+    if (deterministic < 0) {
+        const char *env = getenv("TOOLBOX_DETERMINISTIC");
+        deterministic = (env && *env && strcmp(env, "0") != 0);
+    }
+    return deterministic;
+}
+
+void reduce_init(reduce_stats *st)
+{
+    st->sum = st->sumsq = 0.0;
+    st->min = INFINITY;
+    st->max = -INFINITY;
+    st->n = 0;
+}
+
+void reduce_add(reduce_stats *st, double x)
+{
+    st->sum += x;
+    st->sumsq += x * x;
+    if (x < st->min) st->min = x;
+    if (x > st->max) st->max = x;
+    st->n++;
+}
+
+void reduce_merge(reduce_stats *into, const reduce_stats *from)
+{
+    into->sum += from->sum;
+    into->sumsq += from->sumsq;
+    if (from->min < into->min) into->min = from->min;
+    if (from->max > into->max) into->max = from->max;
+    into->n += from->n;
+}
+
+// ---- Deterministic: one partial per fixed chunk ----
+
+typedef struct {
+    reduce_leaf_t leaf;
+    void         *ctx;
+    size_t        n;
+    reduce_stats *partial;
+} chunk_job;
+
+static void chunk_body(size_t lo, size_t hi, void *arg)
+{
+    const chunk_job *j = arg;
+    size_t c;
+
+    for (c = lo; c < hi; c++) {
+        size_t first = c * REDUCE_CHUNK;
+        size_t last = first + REDUCE_CHUNK < j->n ? first + REDUCE_CHUNK : j->n;
+        reduce_init(&j->partial[c]);
+        j->leaf(first, last, j->ctx, &j->partial[c]);
+    }
+}
+
+static int reduce_chunked(size_t n, reduce_leaf_t leaf, void *ctx, reduce_stats *out)
+{
+    size_t chunks = (n + REDUCE_CHUNK - 1) / REDUCE_CHUNK, step, i;
+    arena_mark_t mark = arena_mark(&request_arena);
+    chunk_job job;
+
+    job.partial = arena_alloc(&request_arena, sizeof(reduce_stats) * chunks);
+    if (!job.partial) return -1;
+    job.leaf = leaf;
+    job.ctx = ctx;
+    job.n = n;
+
+    parallel_for(0, chunks, 1, chunk_body, &job);
+
+    // pairwise tree in chunk order
+    for (step = 1; step < chunks; step *= 2)
+        for (i = 0; i + step < chunks; i += 2 * step)
+            reduce_merge(&job.partial[i], &job.partial[i + step]);
+
+    *out = job.partial[0];
+    arena_release(&request_arena, mark);
+    return 0;
+}
+
+// ---- Fast: one running partial per worker ----
+
+typedef struct {
+    reduce_leaf_t   leaf;
+    void           *ctx;
+    reduce_stats    partial[REDUCE_MAX_WORKERS];
+} worker_job;
+
+static void worker_body(size_t lo, size_t hi, void *arg)
+{
+    worker_job *j = arg;
+    int w = sched_worker_id();
+    reduce_stats st;
+
+    reduce_init(&st);
+    j->leaf(lo, hi, j->ctx, &st);
+    reduce_merge(&j->partial[w < 0 ? 0 : w % REDUCE_MAX_WORKERS], &st);
+}
+
+void parallel_reduce(size_t n, reduce_leaf_t leaf, void *ctx, reduce_stats *out)
+{
+    static worker_job job;   // large, and only one reduction runs at a time
+    int w;
+
+    reduce_init(out);
+    if (n == 0) return;
+
+    if (reduce_deterministic() && reduce_chunked(n, leaf, ctx, out) == 0) return;
+
+    job.leaf = leaf;
+    job.ctx = ctx;
+    for (w = 0; w < REDUCE_MAX_WORKERS; w++) reduce_init(&job.partial[w]);
+
+    parallel_for(0, n, REDUCE_CHUNK, worker_body, &job);
+
+    for (w = 0; w < REDUCE_MAX_WORKERS; w++) reduce_merge(out, &job.partial[w]);
+}
+
+static void array_leaf(size_t lo, size_t hi, void *ctx, reduce_stats *st)
+{
+    const double *x = ctx;
+    size_t i;
+    for (i = lo; i < hi; i++) reduce_add(st, x[i]);
+}
+
+void parallel_stats(const double x[], size_t n, reduce_stats *out)
+{
+    parallel_reduce(n, array_leaf, (void *)x, out);
+}
+
+double parallel_sum(const double x[], size_t n)
+{
+    reduce_stats st;
+    parallel_stats(x, n, &st);
+    return st.sum;
+}
@@ -0,0 +1,38 @@
+#ifndef REDUCE_H
+#define REDUCE_H
+
+#include <stddef.h>
+
+// Parallel reductions (sum, sum of squares, min, max)
+// In deterministic mode the input is cut into fixed REDUCE_CHUNK pieces
+// whatever the thread count, each piece is reduced on its own and the
+// partial results are combined as a fixed pairwise tree. The result is
+// then bit-identical for 1 or N threads. Otherwise each worker keeps
+// a running partial, which is faster but depends on the scheduling.
+
+#define REDUCE_CHUNK 4096
+
+typedef struct {
+    double sum, sumsq;
+    double min, max;
+    size_t n;
+} reduce_stats;
+
+// Reduces items [lo, hi) into *st (st starts empty)
+typedef void (*reduce_leaf_t)(size_t lo, size_t hi, void *ctx, reduce_stats *st);
+
+// Deterministic mode: on/off, default from TOOLBOX_DETERMINISTIC
+void reduce_set_deterministic(int on);
+int  reduce_deterministic(void);
+
+void reduce_init(reduce_stats *st);
+void reduce_add(reduce_stats *st, double x);
+void reduce_merge(reduce_stats *into, const reduce_stats *from);
+
+void parallel_reduce(size_t n, reduce_leaf_t leaf, void *ctx, reduce_stats *out);
+
+// Sum / stats of an array
+double parallel_sum(const double x[], size_t n);
+void   parallel_stats(const double x[], size_t n, reduce_stats *out);
+
+#endif
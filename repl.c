@@ -0,0 +1,730 @@
+// Expression REPL
+// Lines are parsed by a recursive descent compiler into a compact bytecode
+// (1 byte opcode + 16-bit operands) and run by a stack interpreter that
+// calls the kernels in funcs.c. Scalars and vectors share one value type,
+// arithmetic and scalar functions broadcast over vectors. Variables live in
+// the session workspace, so module results can be used directly.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <unistd.h>
+#include "funcs.h"
+#include "repl.h"
+#include "workspace.h"
+
+#define REPL_MAX_CODE    4096
+#define REPL_MAX_CONSTS  256
+#define REPL_MAX_STACK   64
+#define REPL_MAX_DEPTH   256         // nesting of the recursive descent
+#define REPL_MAX_LINE    1024
+#define REPL_MAX_MAPS    8
+#define REPL_SCRATCH     (1 << 18)   // doubles of per-line vector storage
+#define REPL_PRINT_MAX   16          // vector elements printed in full
+
+// A scalar (v == NULL) or a vector of n doubles
+typedef struct {
+    double  x;
+    double *v;
+    int     n;
+} repl_value;
+
+enum {
+    OP_CONST,      // k     push consts[k]
+    OP_LOAD,       // v     push workspace slot v
+    OP_STORE,      // v     workspace slot v = top (value stays on the stack)
+    OP_POP,
+    OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW, OP_NEG,
+    OP_CALL,       // f n   call builtin f with n arguments
+    OP_VEC,        // n     pop n scalars/vectors, push them concatenated
+    OP_MAP_START,  // v     pop vector, open a map over it bound to slot v
+    OP_MAP_NEXT,   // a     bind next element, or jump to a when done
+    OP_MAP_PUSH,   // a     pop body result into the map output, jump to a
+    OP_MAP_END,    //       close the map and push its output vector
+    OP_HALT
+};
+
+// Builtin functions
+enum {
+    FN_SERIES, FN_PAR, FN_RC_CHARGE, FN_RC_DISCHARGE, FN_TAU,
+    FN_OHM, FN_AMPS, FN_VOLTS, FN_POWER,
+    FN_SQRT, FN_EXP, FN_LN, FN_LOG10, FN_SIN, FN_COS, FN_ABS,
+    FN_SUM, FN_MEAN, FN_MIN, FN_MAX, FN_LEN, FN_RANGE,
+    FN_ADD, FN_SUB, FN_MUL, FN_DIV, FN_POW, FN_NEG   // operators, not callable
+};
+
+typedef struct {
+    const char *name;
+    int         id;
+    int         min_args, max_args;   // max_args -1 = any number
+    const char *help;
+} repl_builtin;
+
+static const repl_builtin builtins[] = {
+    { "series",       FN_SERIES,       1, -1, "series(R1, R2, ...)  series resistance" },
+    { "par",          FN_PAR,          1, -1, "par(R1, R2, ...)     parallel resistance" },
+    { "rc_charge",    FN_RC_CHARGE,    4,  4, "rc_charge(R, C, V, t)" },
+    { "rc_discharge", FN_RC_DISCHARGE, 4,  4, "rc_discharge(R, C, V0, t)" },
+    { "tau",          FN_TAU,          2,  2, "tau(R, C)            time constant" },
+    { "ohm",          FN_OHM,          2,  2, "ohm(V, I)            resistance V/I" },
+    { "amps",         FN_AMPS,         2,  2, "amps(V, R)           current V/R" },
+    { "volts",        FN_VOLTS,        2,  2, "volts(I, R)          voltage I*R" },
+    { "power",        FN_POWER,        2,  2, "power(V, I)          power V*I" },
+    { "sqrt",         FN_SQRT,         1,  1, NULL },
+    { "exp",          FN_EXP,          1,  1, NULL },
+    { "ln",           FN_LN,           1,  1, NULL },
+    { "log10",        FN_LOG10,        1,  1, NULL },
+    { "sin",          FN_SIN,          1,  1, NULL },
+    { "cos",          FN_COS,          1,  1, NULL },
+    { "abs",          FN_ABS,          1,  1, NULL },
+    { "sum",          FN_SUM,          1, -1, NULL },
+    { "mean",         FN_MEAN,         1, -1, NULL },
+    { "min",          FN_MIN,          1, -1, NULL },
+    { "max",          FN_MAX,          1, -1, NULL },
+    { "len",          FN_LEN,          1, -1, NULL },
+    { "range",        FN_RANGE,        2,  3, "range(a, b[, step])  vector a..b inclusive" },
+};
+
+#define BUILTIN_COUNT (int)(sizeof(builtins) / sizeof(builtins[0]))
+
+// Per-line vector storage, reset before every line
+static double repl_scratch[REPL_SCRATCH];
+static int    scratch_used;
+
+static char   repl_error[128];
+
+// ---- Compiler ----
+
+typedef struct {
+    const char   *src, *p;
+    unsigned char code[REPL_MAX_CODE];
+    int           len;
+    double        consts[REPL_MAX_CONSTS];
+    int           nconsts;
+    int           depth;
+    int           failed;
+} repl_compiler;
+
+static void compile_error(repl_compiler *c, const char *msg)
+{
+    if (!c->failed)
+        snprintf(repl_error, sizeof(repl_error), "%s at column %d",
+                 msg, (int)(c->p - c->src) + 1);
+    c->failed = 1;
+}
+
+static void skip_space(repl_compiler *c)
+{
+    while (*c->p == ' ' || *c->p == '\t') c->p++;
+}
+
+static int accept(repl_compiler *c, char ch)
+{
+    skip_space(c);
+    if (*c->p != ch) return 0;
+    c->p++;
+    return 1;
+}
+
+static void expect(repl_compiler *c, char ch)
+{
+    char msg[32];
+    if (accept(c, ch)) return;
+    snprintf(msg, sizeof(msg), "expected '%c'", ch);
+    compile_error(c, msg);
+}
+
+static void emit(repl_compiler *c, int byte)
+{
+    if (c->len >= REPL_MAX_CODE) { compile_error(c, "expression too long"); return; }
+    c->code[c->len++] = (unsigned char)byte;
+}
+
+static void emit16(repl_compiler *c, int op, int arg)
+{
+    emit(c, op);
+    emit(c, arg & 0xff);
+    emit(c, (arg >> 8) & 0xff);
+}
+
+static void patch16(repl_compiler *c, int at, int arg)
+{
+    c->code[at]     = (unsigned char)(arg & 0xff);
+    c->code[at + 1] = (unsigned char)((arg >> 8) & 0xff);
+}
+
+// Finds or creates the workspace slot of a variable
+static int var_slot(repl_compiler *c, const char *name, int len)
+{
+    int slot = ws_slot(name, len, 1);
+    if (slot < 0) { compile_error(c, "bad name or workspace full"); return 0; }
+    return slot;
+}
+
+static int read_ident(repl_compiler *c, const char **start)
+{
+    skip_space(c);
+    *start = c->p;
+    if (!isalpha((unsigned char)*c->p) && *c->p != '_') return 0;
+    while (isalnum((unsigned char)*c->p) || *c->p == '_') c->p++;
+    return (int)(c->p - *start);
+}
+
+static void compile_expr(repl_compiler *c);
+
+// Number literal: digits, fraction, exponent, then an optional SI suffix
+// ("4.7k", "1e-3", "4k7"); the text is handed to parse_si_value()
+static void compile_number(repl_compiler *c)
+{
+    const char *start = c->p;
+    char tok[64];
+    double val;
+    int n;
+
+    while (isdigit((unsigned char)*c->p) || *c->p == '.') c->p++;
+    if ((*c->p == 'e' || *c->p == 'E') &&
+        (isdigit((unsigned char)c->p[1]) ||
+         ((c->p[1] == '-' || c->p[1] == '+') && isdigit((unsigned char)c->p[2])))) {
+        c->p += 2;
+        while (isdigit((unsigned char)*c->p)) c->p++;
+    }
+    if (strchr("pnumkKMGR", *c->p) && *c->p &&
+        !isalpha((unsigned char)c->p[1]) && c->p[1] != '_') {
+        c->p++;
+        while (isdigit((unsigned char)*c->p)) c->p++;
+    }
+
+    n = (int)(c->p - start);
+    if (n >= (int)sizeof(tok)) { compile_error(c, "number too long"); return; }
+    memcpy(tok, start, n);
+    tok[n] = '\0';
+    if (parse_si_value(tok, &val) != 0) { compile_error(c, "bad number"); return; }
+
+    if (c->nconsts >= REPL_MAX_CONSTS) { compile_error(c, "too many constants"); return; }
+    c->consts[c->nconsts] = val;
+    emit16(c, OP_CONST, c->nconsts++);
+}
+
+// map(x, vector, body): body is compiled inline as a loop
+static void compile_map(repl_compiler *c)
+{
+    const char *name;
+    int len, slot, loop, exit_at;
+
+    len = read_ident(c, &name);
+    if (!len) { compile_error(c, "map needs a variable name"); return; }
+    slot = var_slot(c, name, len);
+    expect(c, ',');
+    compile_expr(c);
+    expect(c, ',');
+
+    emit16(c, OP_MAP_START, slot);
+    loop = c->len;
+    emit16(c, OP_MAP_NEXT, 0);
+    exit_at = c->len - 2;
+    compile_expr(c);
+    emit16(c, OP_MAP_PUSH, loop);
+    patch16(c, exit_at, c->len);
+    emit(c, OP_MAP_END);
+    expect(c, ')');
+}
+
+static void compile_call(repl_compiler *c, const char *name, int len)
+{
+    int i, argc = 0;
+
+    if (len == 3 && strncmp(name, "map", 3) == 0) { compile_map(c); return; }
+
+    for (i = 0; i < BUILTIN_COUNT; i++)
+        if ((int)strlen(builtins[i].name) == len && strncmp(builtins[i].name, name, len) == 0)
+            break;
+    if (i == BUILTIN_COUNT) { compile_error(c, "unknown function"); return; }
+
+    if (!accept(c, ')')) {
+        do { compile_expr(c); argc++; } while (!c->failed && accept(c, ','));
+        expect(c, ')');
+    }
+    if (argc < builtins[i].min_args ||
+        (builtins[i].max_args >= 0 && argc > builtins[i].max_args)) {
+        compile_error(c, "wrong number of arguments");
+        return;
+    }
+    emit(c, OP_CALL);
+    emit(c, i);
+    emit(c, argc);
+}
+
+static void compile_primary(repl_compiler *c)
+{
+    const char *name;
+    int len, n = 0;
+
+    skip_space(c);
+
+    if (isdigit((unsigned char)*c->p) || (*c->p == '.' && isdigit((unsigned char)c->p[1]))) {
+        compile_number(c);
+    } else if (accept(c, '(')) {
+        compile_expr(c);
+        expect(c, ')');
+    } else if (accept(c, '[')) {
+        if (!accept(c, ']')) {
+            do { compile_expr(c); n++; } while (!c->failed && accept(c, ','));
+            expect(c, ']');
+        }
+        emit16(c, OP_VEC, n);
+    } else if ((len = read_ident(c, &name)) > 0) {
+        if (accept(c, '(')) compile_call(c, name, len);
+        else emit16(c, OP_LOAD, var_slot(c, name, len));
+    } else {
+        compile_error(c, "expected a value");
+    }
+}
+
+static void compile_unary(repl_compiler *c);
+
+static void compile_power(repl_compiler *c)
+{
+    compile_primary(c);
+    if (accept(c, '^')) {
+        compile_unary(c);   // right associative
+        emit(c, OP_POW);
+    }
+}
+
+// Every nesting (parentheses, calls, vectors, unary signs, powers) passes
+// through here, so this is where the recursion depth is bounded
+static void compile_unary(repl_compiler *c)
+{
+    if (c->failed) return;
+    if (c->depth >= REPL_MAX_DEPTH) { compile_error(c, "expression too deep"); return; }
+    c->depth++;
+    if (accept(c, '-')) { compile_unary(c); emit(c, OP_NEG); }
+    else if (accept(c, '+')) compile_unary(c);
+    else compile_power(c);
+    c->depth--;
+}
+
+static void compile_term(repl_compiler *c)
+{
+    compile_unary(c);
+    while (!c->failed) {
+        if (accept(c, '*'))      { compile_unary(c); emit(c, OP_MUL); }
+        else if (accept(c, '/')) { compile_unary(c); emit(c, OP_DIV); }
+        else break;
+    }
+}
+
+static void compile_expr(repl_compiler *c)
+{
+    if (c->failed) return;
+    compile_term(c);
+    while (!c->failed) {
+        if (accept(c, '+'))      { compile_term(c); emit(c, OP_ADD); }
+        else if (accept(c, '-')) { compile_term(c); emit(c, OP_SUB); }
+        else break;
+    }
+}
+
+// statement := name '=' expr | expr   (the result is also stored in "ans")
+static int compile_line(repl_compiler *c, const char *line)
+{
+    const char *name, *save;
+    int len, target = -1;
+
+    memset(c, 0, sizeof(*c));
+    c->src = c->p = line;
+
+    save = c->p;
+    len = read_ident(c, &name);
+    if (len && accept(c, '=')) target = var_slot(c, name, len);
+    else c->p = save;
+
+    compile_expr(c);
+    skip_space(c);
+    if (!c->failed && *c->p != '\0') compile_error(c, "unexpected input");
+
+    emit16(c, OP_STORE, target >= 0 ? target : var_slot(c, "ans", 3));
+    emit(c, OP_HALT);
+    return c->failed ? -1 : 0;
+}
+
+// ---- Interpreter ----
+
+static double *scratch_alloc(int n)
+{
+    double *p;
+    if (n > REPL_SCRATCH - scratch_used) return NULL;
+    p = repl_scratch + scratch_used;
+    scratch_used += n;
+    return p;
+}
+
+static int runtime_error(const char *msg)
+{
+    snprintf(repl_error, sizeof(repl_error), "%s", msg);
+    return -1;
+}
+
+static double elem(const repl_value *a, int i)
+{
+    return a->v ? a->v[i] : a->x;
+}
+
+// Common length of broadcast arguments: 0 = all scalar, -1 = mismatch
+static int broadcast_len(const repl_value *args, int argc)
+{
+    int i, n = 0;
+    for (i = 0; i < argc; i++) {
+        if (!args[i].v) continue;
+        if (n && args[i].n != n) return -1;
+        n = args[i].n;
+    }
+    return n;
+}
+
+static double scalar_fn(int id, const double *a)
+{
+    switch (id) {
+    case FN_RC_CHARGE:    return rc_charge((float)a[0], (float)a[1], (float)a[2], (float)a[3]);
+    case FN_RC_DISCHARGE: return rc_discharge((float)a[0], (float)a[1], (float)a[2], (float)a[3]);
+    case FN_TAU:   return a[0] * a[1];
+    case FN_OHM:   return calc_resistance((float)a[0], (float)a[1]);
+    case FN_AMPS:  return calc_current((float)a[0], (float)a[1]);
+    case FN_VOLTS: return calc_voltage((float)a[0], (float)a[1]);
+    case FN_POWER: return calc_power((float)a[0], (float)a[1]);
+    case FN_SQRT:  return sqrt(a[0]);
+    case FN_EXP:   return exp(a[0]);
+    case FN_LN:    return log(a[0]);
+    case FN_LOG10: return log10(a[0]);
+    case FN_SIN:   return sin(a[0]);
+    case FN_COS:   return cos(a[0]);
+    case FN_ABS:   return fabs(a[0]);
+    case FN_ADD:   return a[0] + a[1];
+    case FN_SUB:   return a[0] - a[1];
+    case FN_MUL:   return a[0] * a[1];
+    case FN_DIV:   return a[0] / a[1];
+    case FN_POW:   return pow(a[0], a[1]);
+    default:       return -a[0];   // FN_NEG
+    }
+}
+
+// Applies a scalar function element by element (scalars broadcast)
+// out may alias args[0]
+static int apply_elementwise(int id, const repl_value *args, int argc, repl_value *out)
+{
+    repl_value r = { 0.0, NULL, 0 };
+    double a[4];
+    int i, j, n = broadcast_len(args, argc);
+
+    if (n < 0) return runtime_error("vector lengths differ");
+
+    if (n == 0) {
+        for (j = 0; j < argc; j++) a[j] = args[j].x;
+        r.x = scalar_fn(id, a);
+    } else {
+        r.v = scratch_alloc(n);
+        r.n = n;
+        if (!r.v) return runtime_error("out of vector memory");
+        for (i = 0; i < n; i++) {
+            for (j = 0; j < argc; j++) a[j] = elem(&args[j], i);
+            r.v[i] = scalar_fn(id, a);
+        }
+    }
+    *out = r;
+    return 0;
+}
+
+// Concatenates all arguments into one flat vector in scratch memory
+// out may alias args[0]
+static int flatten(const repl_value *args, int argc, repl_value *out)
+{
+    repl_value r = { 0.0, NULL, 0 };
+    int i, j, n = 0;
+
+    for (i = 0; i < argc; i++) n += args[i].v ? args[i].n : 1;
+    r.v = scratch_alloc(n > 0 ? n : 1);
+    r.n = n;
+    if (!r.v) return runtime_error("out of vector memory");
+
+    for (i = 0, n = 0; i < argc; i++) {
+        if (!args[i].v) r.v[n++] = args[i].x;
+        else for (j = 0; j < args[i].n; j++) r.v[n++] = args[i].v[j];
+    }
+    *out = r;
+    return 0;
+}
+
+// Series/parallel through the float kernels in funcs.c
+static double resistor_network(int id, const repl_value *flat)
+{
+    float *R = (float *)scratch_alloc(flat->n / 2 + 1);
+    int i;
+
+    if (!R) return NAN;
+    for (i = 0; i < flat->n; i++) R[i] = (float)flat->v[i];
+    return (id == FN_SERIES) ? calc_series(R, flat->n) : calc_parallel(R, flat->n);
+}
+
+static int call_builtin(int id, repl_value *args, int argc, repl_value *out)
+{
+    repl_value flat;
+    int i;
+
+    switch (id) {
+    case FN_SERIES: case FN_PAR:
+    case FN_SUM: case FN_MEAN: case FN_MIN: case FN_MAX: case FN_LEN:
+        if (flatten(args, argc, &flat) != 0) return -1;
+        out->v = NULL;
+        if (id == FN_LEN) { out->x = flat.n; return 0; }
+        if (flat.n == 0) return runtime_error("empty vector");
+        if (id == FN_SERIES || id == FN_PAR) {
+            out->x = resistor_network(id, &flat);
+            return isnan(out->x) ? runtime_error("out of vector memory") : 0;
+        }
+        out->x = flat.v[0];
+        for (i = 1; i < flat.n; i++) {
+            if (id == FN_MIN)      { if (flat.v[i] < out->x) out->x = flat.v[i]; }
+            else if (id == FN_MAX) { if (flat.v[i] > out->x) out->x = flat.v[i]; }
+            else out->x += flat.v[i];
+        }
+        if (id == FN_MEAN) out->x /= flat.n;
+        return 0;
+
+    case FN_RANGE: {
+        double a = args[0].x, b = args[1].x, step = (argc == 3) ? args[2].x : 1.0;
+        double count;
+        if (args[0].v || args[1].v || (argc == 3 && args[2].v))
+            return runtime_error("range needs scalar arguments");
+        if (step == 0.0 || (b - a) / step < 0.0) return runtime_error("bad range step");
+        count = floor((b - a) / step + 1e-9) + 1;
+        if (count > REPL_SCRATCH) return runtime_error("range too long");
+        out->n = (int)count;
+        out->v = scratch_alloc(out->n);
+        if (!out->v) return runtime_error("out of vector memory");
+        for (i = 0; i < out->n; i++) out->v[i] = a + i * step;
+        return 0;
+    }
+
+    default:
+        return apply_elementwise(id, args, argc, out);
+    }
+}
+
+// Copies a value into a workspace slot
+static int store_var(int slot, const repl_value *val)
+{
+    if (ws_store(slot, val->x, val->v, val->n) != 0)
+        return runtime_error("out of workspace memory");
+    return 0;
+}
+
+typedef struct {
+    repl_value src;     // vector being mapped
+    int        index;   // next element
+    int        slot;    // bound variable
+    double    *out;     // results (grown in scratch)
+} repl_map;
+
+static int run(const repl_compiler *c, repl_value *result)
+{
+    repl_value stack[REPL_MAX_STACK];
+    repl_map   maps[REPL_MAX_MAPS];
+    int sp = 0, mp = 0, pc = 0;
+
+    for (;;) {
+        int op = c->code[pc++];
+        int arg = 0;
+
+        if (op == OP_CONST || op == OP_LOAD || op == OP_STORE || op == OP_VEC ||
+            op == OP_MAP_START || op == OP_MAP_NEXT || op == OP_MAP_PUSH) {
+            arg = c->code[pc] | (c->code[pc + 1] << 8);
+            pc += 2;
+        }
+
+        if (sp >= REPL_MAX_STACK - 1) return runtime_error("expression too deep");
+
+        switch (op) {
+        case OP_CONST:
+            stack[sp].x = c->consts[arg];
+            stack[sp++].v = NULL;
+            break;
+
+        case OP_LOAD: {
+            const ws_entry *e = ws_at(arg);
+            if (!e->defined) {
+                snprintf(repl_error, sizeof(repl_error),
+                         "undefined variable '%s'", e->name);
+                return -1;
+            }
+            stack[sp].x = e->x;
+            stack[sp].v = e->array ? e->v : NULL;
+            stack[sp++].n = e->n;
+            break;
+        }
+
+        case OP_STORE:
+            if (store_var(arg, &stack[sp - 1]) != 0) return -1;
+            break;
+
+        case OP_POP:
+            sp--;
+            break;
+
+        case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_POW:
+            sp--;
+            if (apply_elementwise(FN_ADD + (op - OP_ADD), &stack[sp - 1], 2,
+                                  &stack[sp - 1]) != 0) return -1;
+            break;
+
+        case OP_NEG:
+            if (apply_elementwise(FN_NEG, &stack[sp - 1], 1, &stack[sp - 1]) != 0) return -1;
+            break;
+
+        case OP_CALL: {
+            int id = builtins[c->code[pc]].id, argc = c->code[pc + 1];
+            pc += 2;
+            sp -= argc;
+            if (call_builtin(id, &stack[sp], argc, &stack[sp]) != 0) return -1;
+            sp++;
+            break;
+        }
+
+        case OP_VEC:
+            sp -= arg;
+            if (flatten(&stack[sp], arg, &stack[sp]) != 0) return -1;
+            sp++;
+            break;
+
+        case OP_MAP_START:
+            if (mp >= REPL_MAX_MAPS) return runtime_error("map nested too deep");
+            // copy the source, the loop variable may be its workspace slot
+            if (flatten(&stack[sp - 1], 1, &maps[mp].src) != 0) return -1;
+            sp--;
+            maps[mp].index = 0;
+            maps[mp].slot = arg;
+            maps[mp].out = scratch_alloc(maps[mp].src.n);
+            if (!maps[mp].out) return runtime_error("out of vector memory");
+            mp++;
+            break;
+
+        case OP_MAP_NEXT: {
+            repl_map *m = &maps[mp - 1];
+            if (m->index >= m->src.n) { pc = arg; break; }
+            ws_store(m->slot, m->src.v[m->index], NULL, 0);
+            break;
+        }
+
+        case OP_MAP_PUSH: {
+            repl_map *m = &maps[mp - 1];
+            repl_value *r = &stack[--sp];
+            if (r->v) return runtime_error("map body must give a scalar");
+            m->out[m->index++] = r->x;
+            pc = arg;
+            break;
+        }
+
+        case OP_MAP_END:
+            mp--;
+            stack[sp].v = maps[mp].out;
+            stack[sp++].n = maps[mp].src.n;
+            break;
+
+        case OP_HALT:
+            *result = stack[sp - 1];
+            return 0;
+
+        default:
+            return runtime_error("bad bytecode");
+        }
+    }
+}
+
+static void print_value(const repl_value *val)
+{
+    int i;
+
+    if (!val->v) { printf("%.6g\n", val->x); return; }
+
+    printf("[");
+    for (i = 0; i < val->n && i < REPL_PRINT_MAX; i++)
+        printf("%s%.6g", i ? ", " : "", val->v[i]);
+    if (val->n > REPL_PRINT_MAX) printf(", ... (%d values)", val->n);
+    printf("]\n");
+}
+
+static void print_help(void)
+{
+    int i;
+
+    printf("Expressions: + - * / ^, ( ), vectors [a, b, c], SI suffixes (4k7, 10u, 5m)\n");
+    printf("Variables:   name = expr   (last result is 'ans')\n");
+    printf("map(x, vec, expr)    evaluate expr for each element x of vec\n");
+    for (i = 0; i < BUILTIN_COUNT; i++)
+        if (builtins[i].help) printf("%s\n", builtins[i].help);
+    printf("Also: sqrt exp ln log10 sin cos abs sum mean min max len\n");
+    printf("Commands: :vars  :clear  :load name file  :help  :quit\n");
+}
+
+int repl_eval_line(const char *line)
+{
+    static repl_compiler c;   // large, keep off the stack
+    repl_value result;
+
+    scratch_used = 0;
+    if (compile_line(&c, line) != 0 || run(&c, &result) != 0) {
+        printf("Error: %s\n", repl_error);
+        return -1;
+    }
+    print_value(&result);
+    return 0;
+}
+
+// ":load name file" reads a column of numbers into the workspace
+static void repl_load(char *args)
+{
+    char *name = strtok(args, " \t");
+    char *path = strtok(NULL, " \t");
+    int n;
+
+    if (!name || !path) { printf("Usage: :load name file\n"); return; }
+    n = ws_load_file(name, path);
+    if (n < 0) printf("Error: cannot load '%s'\n", path);
+    else printf("%s = %d values\n", name, n);
+}
+
+void repl_run(void)
+{
+    char line[REPL_MAX_LINE];
+    int interactive = isatty(0);
+
+    if (interactive) printf("\nExpression REPL (:help for syntax, :quit to leave)\n");
+
+    for (;;) {
+        char *s;
+
+        if (interactive) { printf("> "); fflush(stdout); }
+        if (!fgets(line, sizeof(line), stdin)) break;
+        if (!strchr(line, '\n') && !feof(stdin)) {
+            int ch;
+
+            // the rest would run as a separate expression, skip it all
+            while ((ch = getchar()) != EOF && ch != '\n') {}
+            printf("Error: line longer than %d characters\n", REPL_MAX_LINE - 2);
+            continue;
+        }
+        line[strcspn(line, "\r\n")] = '\0';
+
+        s = line;
+        while (*s == ' ' || *s == '\t') s++;
+        if (*s == '\0' || *s == '#') continue;
+
+        if (strcmp(s, ":quit") == 0 || strcmp(s, ":q") == 0) break;
+        else if (strcmp(s, ":help") == 0) print_help();
+        else if (strcmp(s, ":vars") == 0) ws_list(stdout);
+        else if (strcmp(s, ":clear") == 0) ws_clear();
+        else if (strncmp(s, ":load ", 6) == 0) repl_load(s + 6);
+        else repl_eval_line(s);
+    }
+}
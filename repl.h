@@ -0,0 +1,18 @@
+#ifndef REPL_H
+#define REPL_H
+
+// Expression REPL
+// A small calculator language over the toolbox kernels, e.g.
+//   r = par(10k, 4k7)
+//   rc_charge(r, 1u, 5, 1m)
+//   map(x, range(1k, 10k, 1k), par(x, 1k))
+// Each line is compiled to bytecode and run by a stack interpreter.
+
+// Interactive loop on stdin (menu entry and "main.out repl")
+void repl_run(void);
+
+// Compiles and runs one line, printing the result
+// Returns 0 on success, -1 on a compile or runtime error
+int repl_eval_line(const char *line);
+
+#endif
@@ -0,0 +1,66 @@
+// Counter-based random numbers (Philox4x32-10, Salmon et al., SC'11)
+
+#include <math.h>
+#include "rng.h"
+
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+
+void philox4x32(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4])
+{
+    uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    int round;
+
+    for (round = 0; round < 10; round++) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+
+        c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        c1 = (uint32_t)p1;
+        c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c3 = (uint32_t)p0;
+
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+// 53 random bits from two words, scaled to [0, 1)
+static double to_unit(uint32_t hi, uint32_t lo)
+{
+    uint64_t bits = ((uint64_t)hi << 21) ^ (lo >> 11);
+    return (double)(bits & ((1ull << 53) - 1)) * (1.0 / 9007199254740992.0);
+}
+
+void rng_uniform2(uint64_t seed, uint64_t index, uint32_t draw, double u[2])
+{
+    uint32_t ctr[4], key[2], out[4];
+
+    ctr[0] = (uint32_t)index;
+    ctr[1] = (uint32_t)(index >> 32);
+    ctr[2] = draw;
+    ctr[3] = 0;
+    key[0] = (uint32_t)seed;
+    key[1] = (uint32_t)(seed >> 32);
+
+    philox4x32(ctr, key, out);
+    u[0] = to_unit(out[0], out[1]);
+    u[1] = to_unit(out[2], out[3]);
+}
+
+double rng_normal(uint64_t seed, uint64_t index, uint32_t draw)
+{
+    double u[2];
+
+    rng_uniform2(seed, index, draw, u);
+    // 1 - u keeps the log argument in (0, 1]
+    return sqrt(-2.0 * log(1.0 - u[0])) * cos(6.283185307179586 * u[1]);
+}
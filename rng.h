@@ -0,0 +1,18 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// Counter-based random numbers (Philox4x32-10)
+// Every random value is a pure function of (seed, counter), so a sample
+// gets the same numbers whichever thread computes it and in any order.
+
+void philox4x32(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4]);
+
+// Two independent uniforms in [0, 1) (53-bit) for sample `index`, draw `draw`
+void rng_uniform2(uint64_t seed, uint64_t index, uint32_t draw, double u[2]);
+
+// Standard normal for sample `index`, draw `draw` (Box-Muller)
+double rng_normal(uint64_t seed, uint64_t index, uint32_t draw);
+
+#endif
@@ -0,0 +1,301 @@
+// Work-stealing task scheduler
+// Deques are small mutex-protected arrays: the owner pushes and pops at the
+// tail, thieves take from the head. Ranges are split lazily, so a job that
+// is never stolen costs only log2(n / grain) pushes and pops.
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "scheduler.h"
+#include "topology.h"
+
+#define SCHED_MAX_THREADS 256
+#define DEQUE_CAP         256
+
+typedef struct {
+    size_t lo, hi;
+} sched_range;
+
+typedef struct {
+    pthread_mutex_t lock;
+    sched_range     items[DEQUE_CAP];
+    int             head, tail;   // steal at head, push/pop at tail
+    pthread_t       thread;
+} sched_worker;
+
+static sched_worker    workers[SCHED_MAX_THREADS];
+static int             nworkers;           // running pool size (0 = not started)
+static int             wanted;             // requested size, 0 = default
+static int             pin_mode = -1;      // TOPO_PIN_*, -1 = from environment
+static int             pinned_mode;        // mode the running pool was started with
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  pool_wake = PTHREAD_COND_INITIALIZER;
+static unsigned        generation;         // bumped for every job
+static int             stopping;
+
+// Current job
+static sched_body_t    job_body;
+static void           *job_ctx;
+static size_t          job_grain;
+static int             job_steal;          // 0 = static partition, own deque only
+static atomic_size_t   job_remaining;      // indices not yet processed
+
+static _Thread_local int worker_id = -1;
+
+static int default_threads(void)
+{
+    const char *env = getenv("TOOLBOX_THREADS");
+    long n = env ? strtol(env, NULL, 10) : 0;
+
+    if (n <= 0) n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n <= 0) n = 1;
+    if (n > SCHED_MAX_THREADS) n = SCHED_MAX_THREADS;
+    return (int)n;
+}
+
+static int push(sched_worker *w, sched_range r)
+{
+    int ok = 0;
+    pthread_mutex_lock(&w->lock);
+    if (w->tail < DEQUE_CAP) {
+        w->items[w->tail++] = r;
+        ok = 1;
+    }
+    pthread_mutex_unlock(&w->lock);
+    return ok;
+}
+
+static int pop(sched_worker *w, sched_range *r)
+{
+    int ok = 0;
+    pthread_mutex_lock(&w->lock);
+    if (w->tail > w->head) {
+        *r = w->items[--w->tail];
+        ok = 1;
+    }
+    if (w->tail == w->head) w->head = w->tail = 0;
+    pthread_mutex_unlock(&w->lock);
+    return ok;
+}
+
+static int steal(sched_worker *w, sched_range *r)
+{
+    int ok = 0;
+    pthread_mutex_lock(&w->lock);
+    if (w->tail > w->head) {
+        *r = w->items[w->head++];
+        ok = 1;
+    }
+    if (w->tail == w->head) w->head = w->tail = 0;
+    pthread_mutex_unlock(&w->lock);
+    return ok;
+}
+
+// Splits r down to the grain size, runs the last piece, repeats
+static void execute(int self, sched_range r)
+{
+    while (r.hi - r.lo > job_grain) {
+        size_t mid = r.lo + (r.hi - r.lo) / 2;
+        sched_range upper = { mid, r.hi };
+        if (!push(&workers[self], upper)) break;   // deque full: run it all here
+        r.hi = mid;
+    }
+    job_body(r.lo, r.hi, job_ctx);
+    atomic_fetch_sub(&job_remaining, r.hi - r.lo);
+}
+
+static void run_job(int self)
+{
+    int victim = self, spins = 0;
+
+    while (atomic_load(&job_remaining) > 0) {
+        sched_range r;
+
+        if (pop(&workers[self], &r)) {
+            execute(self, r);
+            continue;
+        }
+
+        // look for work round-robin, starting after the last victim
+        victim = (victim + 1) % nworkers;
+        if (job_steal && victim != self && steal(&workers[victim], &r)) {
+            execute(self, r);
+            spins = 0;
+        } else if (++spins > 4 * nworkers) {
+            sched_yield();
+            spins = 0;
+        }
+    }
+}
+
+// Pins the calling thread to the CPU chosen for this worker
+static void pin_self(int self)
+{
+    cpu_set_t set;
+
+    if (pinned_mode == TOPO_PIN_NONE) return;
+    CPU_ZERO(&set);
+    CPU_SET(topo_cpu_for_worker(self, pinned_mode), &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+static void *worker_main(void *arg)
+{
+    int self = (int)(size_t)arg;
+    unsigned seen = 0;
+
+    worker_id = self;
+    pin_self(self);
+    for (;;) {
+        pthread_mutex_lock(&pool_lock);
+        while (generation == seen && !stopping) pthread_cond_wait(&pool_wake, &pool_lock);
+        seen = generation;
+        if (stopping) {
+            pthread_mutex_unlock(&pool_lock);
+            return NULL;
+        }
+        pthread_mutex_unlock(&pool_lock);
+
+        run_job(self);
+    }
+}
+
+static void sched_start(int n)
+{
+    int i;
+
+    nworkers = n;
+    stopping = 0;
+    pinned_mode = (pin_mode >= 0) ? pin_mode : topo_parse_pin(NULL);
+    for (i = 0; i < n; i++) {
+        pthread_mutex_init(&workers[i].lock, NULL);
+        workers[i].head = workers[i].tail = 0;
+    }
+    for (i = 1; i < n; i++) {
+        if (pthread_create(&workers[i].thread, NULL, worker_main, (void *)(size_t)i) != 0) {
+            // run with the threads we managed to start
+            nworkers = i;
+            break;
+        }
+    }
+    worker_id = 0;
+    pin_self(0);
+}
+
+void sched_shutdown(void)
+{
+    int i;
+
+    if (!nworkers) return;
+    pthread_mutex_lock(&pool_lock);
+    stopping = 1;
+    pthread_cond_broadcast(&pool_wake);
+    pthread_mutex_unlock(&pool_lock);
+
+    for (i = 1; i < nworkers; i++) pthread_join(workers[i].thread, NULL);
+    for (i = 0; i < nworkers; i++) pthread_mutex_destroy(&workers[i].lock);
+    nworkers = 0;
+    worker_id = -1;
+}
+
+void sched_set_threads(int n)
+{
+    if (n > SCHED_MAX_THREADS) n = SCHED_MAX_THREADS;
+    wanted = n;
+}
+
+void sched_set_pinning(int mode)
+{
+    pin_mode = mode;
+}
+
+int sched_threads(void)
+{
+    return wanted > 0 ? wanted : default_threads();
+}
+
+int sched_worker_id(void)
+{
+    return worker_id;
+}
+
+// Starts or resizes the pool, returns the worker count (1 = run inline)
+static int sched_prepare(size_t begin, size_t end)
+{
+    int n;
+
+    // nested call from a worker: run inline
+    if (worker_id > 0 || (worker_id == 0 && atomic_load(&job_remaining) > 0)) return 1;
+
+    n = sched_threads();
+    if (n == 1 || end - begin < 2) return 1;
+    if (nworkers != n ||
+        pinned_mode != ((pin_mode >= 0) ? pin_mode : topo_parse_pin(NULL))) {
+        sched_shutdown();
+        sched_start(n);
+    }
+    return nworkers;
+}
+
+// Publishes the job and runs worker 0's share
+static void sched_launch(void)
+{
+    pthread_mutex_lock(&pool_lock);
+    generation++;
+    pthread_cond_broadcast(&pool_wake);
+    pthread_mutex_unlock(&pool_lock);
+
+    run_job(0);
+}
+
+void parallel_for(size_t begin, size_t end, size_t grain, sched_body_t body, void *ctx)
+{
+    sched_range all = { begin, end };
+
+    if (end <= begin) return;
+    if (grain < 1) grain = 1;
+
+    if (end - begin <= grain || sched_prepare(begin, end) == 1) {
+        body(begin, end, ctx);
+        return;
+    }
+
+    job_body = body;
+    job_ctx = ctx;
+    job_grain = grain;
+    job_steal = 1;
+    atomic_store(&job_remaining, end - begin);
+    push(&workers[0], all);
+    sched_launch();
+}
+
+void parallel_for_static(size_t begin, size_t end, sched_body_t body, void *ctx)
+{
+    size_t count = end - begin;
+    int n, w;
+
+    if (end <= begin) return;
+
+    n = sched_prepare(begin, end);
+    if (n == 1) {
+        body(begin, end, ctx);
+        return;
+    }
+
+    job_body = body;
+    job_ctx = ctx;
+    job_grain = SIZE_MAX;
+    job_steal = 0;
+    atomic_store(&job_remaining, count);
+    for (w = 0; w < n; w++) {
+        sched_range r = { begin + count * w / n, begin + count * (w + 1) / n };
+        if (r.hi > r.lo) push(&workers[w], r);
+    }
+    sched_launch();
+}
@@ -0,0 +1,37 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stddef.h>
+
+// Work-stealing task scheduler
+// One worker per core, each with its own deque of index ranges. A worker
+// splits its range in half until it reaches the grain size, pushing the
+// other halves on its deque; idle workers steal the oldest (largest) ranges
+// from the others. The calling thread takes part as worker 0.
+
+typedef void (*sched_body_t)(size_t lo, size_t hi, void *ctx);
+
+// Thread count: 0 = TOOLBOX_THREADS from the environment, else one per core
+// Takes effect on the next parallel_for (the pool is restarted if needed)
+void sched_set_threads(int n);
+int  sched_threads(void);
+
+// Runs body over [begin, end) in chunks of at least grain indices and
+// returns when every chunk is done. Nested calls from inside a body run
+// serially on the calling worker.
+void parallel_for(size_t begin, size_t end, size_t grain, sched_body_t body, void *ctx);
+
+// Same, but worker w always gets the w-th of nworkers equal contiguous
+// blocks and nothing is stolen. Used with topo_first_touch() so data is
+// processed on the NUMA node it was placed on.
+void parallel_for_static(size_t begin, size_t end, sched_body_t body, void *ctx);
+
+// Worker pinning (TOPO_PIN_* from topology.h), default from TOOLBOX_PIN
+void sched_set_pinning(int mode);
+
+// Index of the calling worker (0 = caller thread), -1 outside the pool
+int  sched_worker_id(void);
+
+void sched_shutdown(void);
+
+#endif
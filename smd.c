@@ -0,0 +1,316 @@
+// SMD resistor markings
+// Decoding is one pass over at most four characters with no string
+// functions; EIA-96 codes index the 96-entry E96 table and the multiplier
+// letter table of mk_eia96 directly. Encoding gets the decade from the
+// IEEE exponent (decimal_exponent) and finds the nearest E96 value with a
+// fixed 7-step search, so neither direction loops over digits or calls libm.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+#include "funcs.h"
+#include "arena.h"
+#include "textio.h"
+#include "eseries.h"
+#include "marking.h"
+#include "scheduler.h"
+#include "smd.h"
+
+#define SMD_GRAIN 16384
+
+// EIA-96 multiplier letter of the exponents -3..5
+static const char eia96_letters[9] = { 'Z', 'Y', 'X', 'A', 'B', 'C', 'D', 'E', 'F' };
+
+static const char *const style_names[] = { "3", "4", "eia96" };
+
+int smd_decode(const char *s, double *R)
+{
+    unsigned v = 0, frac = 0, r_seen = 0;
+    int i, len;
+
+    for (len = 0; len < 5 && s[len]; len++) ;
+    if (len == 1 && s[0] == '0') {          // zero-ohm jumper
+        *R = 0;
+        return SMD_3DIGIT;
+    }
+    if (len < 3 || len > 4) return -1;
+
+    if (len == 3 && (unsigned)(s[2] - '0') >= 10u) {
+        unsigned d0 = (unsigned)(s[0] - '0'), d1 = (unsigned)(s[1] - '0');
+        unsigned c = (unsigned char)s[2], n = d0 * 10 + d1;
+        int e;
+
+        if (d0 > 9 || d1 > 9 || n - 1 >= 96u || c >= 128 || !mk_eia96.mult[c & 0xdf]) return -1;
+        e = mk_eia96.mult[c & 0xdf] - MK_EXP(0);
+        *R = e >= 0 ? e96_values[n - 1] * POW10(e) : e96_values[n - 1] / POW10(-e);
+        return SMD_EIA96;
+    }
+
+    // digits with one optional R as the decimal point, else the last
+    // digit is the multiplier
+    for (i = 0; i < len; i++) {
+        unsigned d = (unsigned)(s[i] - '0');
+        if (d < 10) {
+            v = v * 10 + d;
+            frac += r_seen;
+        } else if ((s[i] == 'R' || s[i] == 'r') && !r_seen) {
+            r_seen = 1;
+        } else {
+            return -1;
+        }
+    }
+    *R = r_seen ? v / POW10(frac) : (v / 10) * POW10(v % 10);
+    return len == 3 ? SMD_3DIGIT : SMD_4DIGIT;
+}
+
+// ndigits significant digits then a multiplier digit, or the digits with
+// an R in place of the decimal point below 10^ndigits
+static int encode_digits(double R, int ndigits, char *out)
+{
+    int m, s, i, k, top = (ndigits == 2) ? 100 : 1000;
+    char d[3];
+
+    if (R == 0) {
+        memset(out, '0', (size_t)ndigits + 1);
+        out[ndigits + 1] = '\0';
+        return 0;
+    }
+    if (!(R >= 1e-3 && R <= 1e12)) return -1;
+
+    m = decimal_exponent(R) - (ndigits - 1);
+    s = (int)((m >= 0 ? R / POW10(m) : R * POW10(-m)) + 0.5);
+    if (s >= top) { s /= 10; m++; }     // 9.96 rounds up to 10
+    if (m > 9 || -m > ndigits) return -1;
+
+    for (i = ndigits; i-- > 0; s /= 10) d[i] = (char)('0' + s % 10);
+    for (k = 0, i = 0; i < ndigits; i++) {
+        if (i == ndigits + m) out[k++] = 'R';
+        out[k++] = d[i];
+    }
+    if (m >= 0) out[k++] = (char)('0' + m);
+    out[k] = '\0';
+    return 0;
+}
+
+static int encode_eia96(double R, char *out)
+{
+    int m, i, step, upper;
+    double x;
+
+    if (!(R >= 1e-3 && R <= 1e12)) return -1;
+
+    m = decimal_exponent(R) - 2;
+    x = m >= 0 ? R / POW10(m) : R * POW10(-m);    // 100 <= x < 1000
+    for (i = 0, step = 64; step; step >>= 1)
+        if (i + step < 96 && e96_values[i + step] <= x) i += step;
+
+    // E96 is geometric, so round at the geometric midpoint; past 976 the
+    // next value is 100 of the next decade
+    upper = (i < 95) ? e96_values[i + 1] : 1000;
+    if (x * x > (double)e96_values[i] * upper) i++;
+    if (i == 96) { i = 0; m++; }
+    if (m < -3 || m > 5) return -1;
+
+    out[0] = (char)('0' + (i + 1) / 10);
+    out[1] = (char)('0' + (i + 1) % 10);
+    out[2] = eia96_letters[m + 3];
+    out[3] = '\0';
+    return 0;
+}
+
+int smd_encode(double R, int style, char out[SMD_CODE_MAX])
+{
+    int rc = -1;
+
+    switch (style) {
+    case SMD_3DIGIT: rc = encode_digits(R, 2, out); break;
+    case SMD_4DIGIT: rc = encode_digits(R, 3, out); break;
+    case SMD_EIA96:  rc = encode_eia96(R, out); break;
+    }
+    if (rc != 0) out[0] = '\0';
+    return rc;
+}
+
+int smd_decode_batch(const char *const code[], int n, double R[])
+{
+    int i, bad = 0;
+
+    for (i = 0; i < n; i++)
+        if (smd_decode(code[i], &R[i]) < 0) {
+            R[i] = -1;
+            bad++;
+        }
+    return bad;
+}
+
+int smd_encode_batch(const double R[], int n, int style, char out[][SMD_CODE_MAX])
+{
+    int i, bad = 0;
+
+    for (i = 0; i < n; i++) bad += (smd_encode(R[i], style, out[i]) != 0);
+    return bad;
+}
+
+// ---- Command line ----
+
+static void smd_usage(void)
+{
+    fprintf(stderr, "Usage: main.out smd decode <code>... | --file codes.txt [-o out.csv] [--threads N]\n"
+                    "       main.out smd encode [--style 3|4|eia96] <ohms>... | --file values.csv\n"
+                    "                           [-o out.csv] [--threads N]\n");
+}
+
+typedef struct {
+    const char *const *code;
+    const double      *R;
+    double            *value;
+    char             (*out)[SMD_CODE_MAX];
+    int                style;
+} smd_job;
+
+static void smd_decode_chunk(size_t lo, size_t hi, void *arg)
+{
+    const smd_job *j = arg;
+    smd_decode_batch(j->code + lo, (int)(hi - lo), j->value + lo);
+}
+
+static void smd_encode_chunk(size_t lo, size_t hi, void *arg)
+{
+    const smd_job *j = arg;
+    smd_encode_batch(j->R + lo, (int)(hi - lo), j->style, j->out + lo);
+}
+
+// Values from a CSV file (first column) or the remaining arguments
+static double *smd_values(const char *in_path, char *args[], int nargs, int *n)
+{
+    double *R;
+    int i;
+
+    if (in_path) {
+        textio_table table;
+        size_t len;
+        char *text = textio_read_file(&request_arena, in_path, &len);
+
+        if (!text) {
+            fprintf(stderr, "smd: cannot read '%s'\n", in_path);
+            return NULL;
+        }
+        if (textio_parse_csv(&request_arena, text, len, &table) != 0) {
+            if (table.bad_row) fprintf(stderr, "smd: bad number on line %zu\n", table.bad_row);
+            else fprintf(stderr, "smd: out of memory\n");
+            return NULL;
+        }
+        if (table.rows > INT_MAX) {
+            fprintf(stderr, "smd: too many rows\n");
+            return NULL;
+        }
+        if (!(R = arena_alloc(&request_arena, sizeof(double) * (table.rows + 1)))) return NULL;
+        for (i = 0; i < (int)table.rows; i++)
+            R[i] = (table.row_start[i + 1] > table.row_start[i]) ? table.values[table.row_start[i]] : 0.0;
+        *n = (int)table.rows;
+        return R;
+    }
+
+    if (!(R = arena_alloc(&request_arena, sizeof(double) * (nargs + 1)))) return NULL;
+    for (i = 0; i < nargs; i++) {
+        char *end;
+        R[i] = strtod(args[i], &end);
+        if (end == args[i] || *end) {
+            fprintf(stderr, "smd: bad value '%s'\n", args[i]);
+            return NULL;
+        }
+    }
+    *n = nargs;
+    return R;
+}
+
+int smd_main(int argc, char *argv[])
+{
+    const char *in_path = NULL, *out_path = NULL;
+    char **args;
+    textio_out out;
+    FILE *fp = stdout;
+    smd_job job;
+    int i, n = 0, nargs = 0, bad = 0, encode;
+
+    if (argc < 2 || (strcmp(argv[1], "decode") != 0 && strcmp(argv[1], "encode") != 0)) {
+        smd_usage();
+        return 1;
+    }
+    encode = (argv[1][0] == 'e');
+    job.style = SMD_3DIGIT;
+
+    args = arena_alloc(&request_arena, sizeof(char *) * argc);
+    if (!args) return 1;
+    for (i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--file") == 0 && i + 1 < argc) in_path = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) out_path = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) sched_set_threads(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--style") == 0 && i + 1 < argc) {
+            for (job.style = 0; job.style < 3; job.style++)
+                if (strcmp(argv[i + 1], style_names[job.style]) == 0) break;
+            if (job.style == 3) { smd_usage(); return 1; }
+            i++;
+        }
+        else args[nargs++] = argv[i];
+    }
+
+    if (encode) {
+        if (!(job.R = smd_values(in_path, args, nargs, &n))) return 1;
+        job.out = arena_alloc(&request_arena, SMD_CODE_MAX * (size_t)(n + 1));
+        if (!job.out) {
+            fprintf(stderr, "smd: out of memory\n");
+            return 1;
+        }
+        parallel_for(0, (size_t)n, SMD_GRAIN, smd_encode_chunk, &job);
+    } else {
+        const char **code = (const char **)args;
+
+        if (in_path) {
+            size_t len;
+            char *data = textio_read_file(&request_arena, in_path, &len);
+            size_t max = len / 2 + 1;
+
+            if (!data || !(code = arena_alloc(&request_arena, sizeof(char *) * max))) {
+                fprintf(stderr, "smd: cannot read '%s'\n", in_path);
+                return 1;
+            }
+            nargs = textio_split_lines(data, len, code, (int)max);
+        }
+        n = nargs;
+        job.code = code;
+        job.value = arena_alloc(&request_arena, sizeof(double) * (n + 1));
+        if (!job.value) {
+            fprintf(stderr, "smd: out of memory\n");
+            return 1;
+        }
+        parallel_for(0, (size_t)n, SMD_GRAIN, smd_decode_chunk, &job);
+    }
+
+    if (out_path && !(fp = fopen(out_path, "w"))) {
+        fprintf(stderr, "smd: cannot write '%s'\n", out_path);
+        return 1;
+    }
+    textio_out_open(&out, fp);
+    for (i = 0; i < n; i++) {
+        if (encode && job.out[i][0]) {
+            textio_write(&out, job.out[i], strlen(job.out[i]));
+            textio_write(&out, "\n", 1);
+        } else if (encode) {
+            textio_write(&out, "invalid\n", 8);
+            bad++;
+        } else if (job.value[i] >= 0) {
+            textio_printf(&out, "%s,%.6g\n", job.code[i], job.value[i]);
+        } else {
+            textio_printf(&out, "%s,invalid\n", job.code[i]);
+            bad++;
+        }
+    }
+    textio_out_close(&out);
+    if (fp != stdout) fclose(fp);
+
+    if (bad) fprintf(stderr, "smd: %d invalid %s\n", bad, encode ? "value(s)" : "code(s)");
+    arena_reset(&request_arena);
+    return bad ? 1 : 0;
+}
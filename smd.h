@@ -0,0 +1,31 @@
+#ifndef SMD_H
+#define SMD_H
+
+// SMD resistor markings
+// 3-digit (E24: "472" = 4.7k, "4R7" = 4.7 Ω), 4-digit (E96 values in
+// full: "4702" = 47k, "47R5" = 47.5 Ω) and EIA-96 (E96 code + multiplier
+// letter: "01C" = 10k). A three-character marking ending in a letter is
+// read as EIA-96, so "47R" is 3.01 Ω and not 47 Ω.
+//
+// "main.out smd decode <code>... | --file codes.txt [-o out.csv]"
+// "main.out smd encode [--style 3|4|eia96] <ohms>... | --file values.csv"
+
+enum { SMD_3DIGIT, SMD_4DIGIT, SMD_EIA96 };
+
+#define SMD_CODE_MAX 6     // longest code plus NUL, rounded up
+
+// Ohms of one marking, returns its style or -1 if it is not a valid code
+int smd_decode(const char *code, double *R);
+
+// Marking of R in the given style (EIA-96 rounds to the nearest E96
+// value), returns 0 on success or -1 if R cannot be marked that way
+int smd_encode(double R, int style, char out[SMD_CODE_MAX]);
+
+// n markings at once; invalid codes decode to -1 and unencodable values
+// to an empty string. Both return the invalid count.
+int smd_decode_batch(const char *const code[], int n, double R[]);
+int smd_encode_batch(const double R[], int n, int style, char out[][SMD_CODE_MAX]);
+
+int smd_main(int argc, char *argv[]);
+
+#endif
@@ -25,9 +25,132 @@ if [ ! -x ./main.out ]; then
   failed=1
 fi
 
+# Deterministic mode must give bit-identical results for any thread count
+if [ $failed -eq 0 ]; then
+  echo "Checking deterministic parallel results..."
+  mc1=$(./main.out mc parallel 1k 2k2 4k7 --N 100k --deterministic --threads 1)
+  mc4=$(./main.out mc parallel 1k 2k2 4k7 --N 100k --deterministic --threads 4)
+  if [ "$mc1" != "$mc4" ]; then
+    echo "Fail: mc differs between 1 and 4 threads"
+    failed=1
+  fi
+
+  csv=$(mktemp)
+  echo "R,C,V,t" > "$csv"
+  for i in $(seq 1 20000); do echo "$((i % 97 + 1))k,1u,5,$((i % 13))m"; done >> "$csv"
+  sum1=$(./main.out batch rc "$csv" --sum --deterministic --threads 1 -o /dev/null 2>&1)
+  sum4=$(./main.out batch rc "$csv" --sum --deterministic --threads 4 -o /dev/null 2>&1)
+  rm -f "$csv"
+  if [ "$sum1" != "$sum4" ]; then
+    echo "Fail: batch --sum differs between 1 and 4 threads"
+    failed=1
+  fi
+fi
+
+# 6-band codes (3 digits, multiplier, tolerance, tempco) and EIA-96 decode
+if [ $failed -eq 0 ]; then
+  echo "Checking marking decoding..."
+  six=$(./main.out marking resistor "brown black black brown brown red")
+  if [ "$six" != "brown black black brown brown red,1000,ohm,±1%,50 ppm/K" ]; then
+    echo "Fail: 6-band code decoded as '$six'"
+    failed=1
+  fi
+  # EIA-96 'H' is x10 like 'B'
+  eia=$(./main.out smd decode 01H)
+  if [ "$eia" != "01H,1000" ]; then
+    echo "Fail: EIA-96 01H decoded as '$eia'"
+    failed=1
+  fi
+  # capacitor Z is asymmetric
+  capz=$(./main.out marking capacitor 104Z)
+  if [ "$capz" != "104Z,100000,pF,+80/-20%" ]; then
+    echo "Fail: capacitor 104Z decoded as '$capz'"
+    failed=1
+  fi
+fi
+
+# Deeply nested or overlong REPL input is an error, not a crash or a split line
+if [ $failed -eq 0 ]; then
+  echo "Checking REPL limits..."
+  deep=$(printf '(%.0s' $(seq 1 20000))1$(printf ')%.0s' $(seq 1 20000))
+  ./main.out repl "$deep" > /dev/null 2>&1
+  if [ $? -gt 1 ]; then
+    echo "Fail: deeply nested expression crashed the REPL"
+    failed=1
+  fi
+  long=$( (printf '1+%.0s' $(seq 1 700); echo 1; echo 2*3) | ./main.out repl)
+  if [ "$long" != "$(printf 'Error: line longer than 1022 characters\n6')" ]; then
+    echo "Fail: overlong REPL line gave '$long'"
+    failed=1
+  fi
+fi
+
+# LED --sum leaves out rows without a result (Vs below Vf, or a resistor
+# past the top of the series) and reports them; a resistor below 0.1 ohm
+# rounds up to 0.1
+if [ $failed -eq 0 ]; then
+  echo "Checking LED batch sums..."
+  led=$(mktemp)
+  printf 'Vs,Vf,I,P\n5,2,0.02,\n2,3,0.02,\n2.001,2,0.02,\n10,0.5,1e-11,0.25\n' > "$led"
+  ledsum=$(./main.out batch led "$led" --sum -o /dev/null 2>&1)
+  ledrow=$(./main.out batch led "$led" | sed -n 4p)
+  rm -f "$led"
+  if [ "$ledsum" != "$(printf 'sum=0.060010000000000001\nbatch: 2 invalid row(s) left out of the sum')" ] ||
+     [ "$ledrow" != "0.05,0.1,0.01,1e-05,0" ]; then
+    echo "Fail: LED batch gave '$ledsum' / '$ledrow'"
+    failed=1
+  fi
+fi
+
+# With --fc the error is of the cutoff frequency: 16k * 10n gives 994.7 Hz,
+# below a 1 kHz target, where the time constant is above its target
+if [ $failed -eq 0 ]; then
+  echo "Checking rcselect cutoff errors..."
+  rc=$(./main.out rcselect --fc 1k --top 1 --N 0 --rmin 16k --rmax 16k --cmin 10n --cmax 10n | tail -1)
+  if [ "$rc" != "1,16000,1e-08,994.718,-0.528,,,," ]; then
+    echo "Fail: rcselect --fc gave '$rc'"
+    failed=1
+  fi
+  # 994.7 Hz is +2.02% off 975 Hz (the time constant only -1.98%), so
+  # --tol 2 has no pick
+  if ./main.out rcselect --fc 975 --top 1 --N 0 --rmin 16k --rmax 16k --cmin 10n --cmax 10n \
+       >/dev/null 2>&1; then
+    echo "Fail: rcselect --fc 975 accepted a pick outside --tol"
+    failed=1
+  fi
+fi
+
+# Interval bounds of inexact results must be strictly outward, also when
+# the optimizer is free to reorder the arithmetic
+if [ $failed -eq 0 ]; then
+  echo "Checking interval bounds..."
+  for bin in ./main.out ./main-O2.out; do
+    [ -x "$bin" ] || continue
+    # P = 0.1 * 0.2 and 0.1 + 0.2 are inexact (I = 0.1 / 0.5 is exact)
+    out=$($bin bounds ohm --V 0.1 --R 0.5; $bin bounds ohm --V 0.1 --R 3; $bin bounds series 0.1 0.2)
+    bad=$(echo "$out" | awk -F'[][, ]+' '/^[PR]=/ { if (!($2 < $3)) print }')
+    if [ -z "$out" ] || [ -n "$bad" ]; then
+      echo "Fail: $bin interval bounds not outward: $bad"
+      failed=1
+    fi
+  done
+fi
+
+# The fixed-point build (make fixed) must refuse values outside its range
+# instead of printing a saturated result
+if [ $failed -eq 0 ] && [ -x ./fixed.out ]; then
+  echo "Checking fixed-point range..."
+  if ./fixed.out ohm --V 1e12 --R 1e-3 >/dev/null 2>&1; then
+    echo "Fail: fixed.out printed a saturated ohm result"
+    failed=1
+  fi
+fi
+
 echo
-echo "Just checking the file compiled successfully, no further tests of functionality"
-echo "This is the only automated check, the rest of your project will be marked manually."
+echo "Checked: the build, thread-count independent batch results, marking"
+echo "decoding, REPL input limits, LED batch sums, rcselect cutoff errors,"
+echo "outward interval bounds and the fixed-point range. Everything else is"
+echo "checked by hand."
 
 
 echo
@@ -0,0 +1,198 @@
+// Bulk text input/output
+// Readers and formatters for the batch modes. All memory comes from the
+// caller's arena or the shared buffer pool, never from malloc per row.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include "funcs.h"
+#include "textio.h"
+
+// Output buffers are recycled between runs instead of reallocated
+static pool_t out_pool = POOL_INIT(&session_arena, TEXTIO_BUF_SIZE);
+
+char *textio_read_file(arena_t *a, const char *path, size_t *len)
+{
+    FILE *fp = fopen(path, "rb");
+    long size;
+    char *text;
+
+    if (!fp) return NULL;
+    if (fseek(fp, 0, SEEK_END) != 0 || (size = ftell(fp)) < 0) {
+        fclose(fp);
+        return NULL;
+    }
+    rewind(fp);
+
+    text = arena_alloc(a, (size_t)size + 1);
+    if (!text || fread(text, 1, (size_t)size, fp) != (size_t)size) {
+        fclose(fp);
+        return NULL;
+    }
+    fclose(fp);
+
+    text[size] = '\0';
+    *len = (size_t)size;
+    return text;
+}
+
+// Parses one field (whitespace trimmed), empty = 0
+static int parse_field(char *s, double *out)
+{
+    char *end;
+
+    while (*s == ' ' || *s == '\t') s++;
+    end = s + strlen(s);
+    while (end > s && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) *--end = '\0';
+
+    if (*s == '\0') { *out = 0.0; return 0; }
+    return parse_si_value(s, out);
+}
+
+int textio_parse_csv(arena_t *a, char *text, size_t len, textio_table *t)
+{
+    size_t i, lines = 1, fields = 1, row = 0, nv = 0, line_no = 0;
+    char *line = text;
+
+    // size the arrays once: count lines and separators
+    for (i = 0; i < len; i++) {
+        if (text[i] == '\n') { lines++; fields++; }
+        else if (text[i] == ',') fields++;
+    }
+
+    t->bad_row = 0;
+    if (fields > SIZE_MAX / sizeof(double) || lines >= SIZE_MAX / sizeof(size_t)) return -1;
+    t->values    = arena_alloc(a, sizeof(double) * fields);
+    t->row_start = arena_alloc(a, sizeof(size_t) * (lines + 1));
+    if (!t->values || !t->row_start) return -1;
+
+    while (line && *line) {
+        char *next = strchr(line, '\n');
+        char *field = line;
+        size_t start = nv;
+        int ok = 1;
+
+        if (next) *next++ = '\0';
+        line_no++;
+
+        // skip blank lines
+        if (line[strspn(line, " \t\r")] == '\0') { line = next; continue; }
+
+        for (;;) {
+            char *comma = strchr(field, ',');
+            if (comma) *comma = '\0';
+            if (parse_field(field, &t->values[nv]) != 0) { ok = 0; break; }
+            nv++;
+            if (!comma) break;
+            field = comma + 1;
+        }
+
+        if (!ok) {
+            nv = start;
+            if (line_no == 1) { line = next; continue; }   // header
+            t->bad_row = line_no;
+            return -1;
+        }
+
+        t->row_start[row++] = start;
+        line = next;
+    }
+
+    t->row_start[row] = nv;
+    t->rows = row;
+    return 0;
+}
+
+// Splits text into lines in place, returns the line count
+int textio_split_lines(char *text, size_t len, const char **lines, int max)
+{
+    char *p = text, *end = text + len;
+    int n = 0;
+
+    while (p < end && n < max) {
+        char *nl = memchr(p, '\n', (size_t)(end - p));
+        if (!nl) nl = end;
+        *nl = '\0';
+        if (nl > p && nl[-1] == '\r') nl[-1] = '\0';
+        if (*p) lines[n++] = p;
+        p = nl + 1;
+    }
+    return n;
+}
+
+void textio_out_open(textio_out *o, FILE *fp)
+{
+    o->fp = fp;
+    o->buf = pool_get(&out_pool);
+    o->len = 0;
+}
+
+static void textio_flush(textio_out *o)
+{
+    if (o->len) fwrite(o->buf, 1, o->len, o->fp);
+    o->len = 0;
+}
+
+void textio_printf(textio_out *o, const char *fmt, ...)
+{
+    va_list ap;
+    int n;
+
+    if (!o->buf) {   // pool exhausted, fall back to stdio buffering
+        va_start(ap, fmt);
+        vfprintf(o->fp, fmt, ap);
+        va_end(ap);
+        return;
+    }
+
+    if (TEXTIO_BUF_SIZE - o->len < 256) textio_flush(o);
+
+    va_start(ap, fmt);
+    n = vsnprintf(o->buf + o->len, TEXTIO_BUF_SIZE - o->len, fmt, ap);
+    va_end(ap);
+
+    if (n < 0) return;
+    if ((size_t)n >= TEXTIO_BUF_SIZE - o->len) {
+        // longer than the space left: flush and format straight to the file
+        textio_flush(o);
+        va_start(ap, fmt);
+        vfprintf(o->fp, fmt, ap);
+        va_end(ap);
+        return;
+    }
+    o->len += (size_t)n;
+}
+
+// Appends n raw bytes (no formatting)
+void textio_write(textio_out *o, const char *s, size_t n)
+{
+    if (!o->buf) {
+        fwrite(s, 1, n, o->fp);
+        return;
+    }
+    if (TEXTIO_BUF_SIZE - o->len < n) {
+        textio_flush(o);
+        if (n > TEXTIO_BUF_SIZE) {
+            fwrite(s, 1, n, o->fp);
+            return;
+        }
+    }
+    memcpy(o->buf + o->len, s, n);
+    o->len += n;
+}
+
+void textio_out_flush(textio_out *o)
+{
+    if (o->buf) textio_flush(o);
+    fflush(o->fp);
+}
+
+void textio_out_close(textio_out *o)
+{
+    if (!o->buf) return;
+    textio_flush(o);
+    pool_put(&out_pool, o->buf);
+    o->buf = NULL;
+}
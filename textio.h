@@ -0,0 +1,47 @@
+#ifndef TEXTIO_H
+#define TEXTIO_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "arena.h"
+
+// Bulk text input/output
+// Files are read whole into an arena and output is formatted into pooled
+// buffers that are written with large fwrite() calls.
+
+#define TEXTIO_BUF_SIZE (256 * 1024)
+
+// Reads a whole file into arena memory (NUL terminated), NULL on error
+char *textio_read_file(arena_t *a, const char *path, size_t *len);
+
+// Splits numeric CSV text into rows (in place, the text is modified)
+// values holds all fields row by row, row_start[r]..row_start[r+1] are the
+// fields of row r. Empty fields are stored as 0. A non-numeric first line is
+// treated as a header and skipped.
+typedef struct {
+    double *values;
+    size_t *row_start;
+    size_t  rows;
+    size_t  bad_row;     // first line number that failed to parse, 0 = none
+} textio_table;
+
+int textio_parse_csv(arena_t *a, char *text, size_t len, textio_table *t);
+
+// Splits text into lines in place (empty lines skipped, CR stripped),
+// stores up to max line pointers and returns the count
+int textio_split_lines(char *text, size_t len, const char **lines, int max);
+
+// Buffered output
+typedef struct {
+    FILE  *fp;
+    char  *buf;
+    size_t len;
+} textio_out;
+
+void textio_out_open(textio_out *o, FILE *fp);      // buffer from the shared pool
+void textio_printf(textio_out *o, const char *fmt, ...);
+void textio_write(textio_out *o, const char *s, size_t n);
+void textio_out_flush(textio_out *o);               // write out everything so far
+void textio_out_close(textio_out *o);               // flush and return the buffer
+
+#endif
@@ -0,0 +1,149 @@
+// CPU / NUMA topology and first-touch memory placement
+// Node membership comes from /sys/devices/system/node/nodeN/cpulist.
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "topology.h"
+#include "scheduler.h"
+
+static pthread_once_t topo_once = PTHREAD_ONCE_INIT;
+static int ncpus = 1, nnodes = 1;
+static short cpu_node[TOPO_MAX_CPUS];
+static short node_cpus[TOPO_MAX_NODES];   // CPUs per node
+
+// Parses a sysfs cpulist ("0-3,8-11") and marks the CPUs as on node
+static void parse_cpulist(const char *list, int node)
+{
+    const char *p = list;
+
+    while (*p && *p != '\n') {
+        char *end;
+        long lo = strtol(p, &end, 10), hi = lo, c;
+
+        if (end == p) break;
+        if (*end == '-') hi = strtol(end + 1, &end, 10);
+        for (c = lo; c <= hi && c < TOPO_MAX_CPUS; c++) {
+            cpu_node[c] = (short)node;
+            node_cpus[node]++;
+        }
+        p = (*end == ',') ? end + 1 : end;
+    }
+}
+
+// Reads the topology once; pinned workers ask for it concurrently when the
+// pool starts, so it goes through pthread_once
+static void topo_read(void)
+{
+    char path[64], buf[1024];
+    int node;
+
+    ncpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpus < 1) ncpus = 1;
+    if (ncpus > TOPO_MAX_CPUS) ncpus = TOPO_MAX_CPUS;
+
+    for (node = 0; node < TOPO_MAX_NODES; node++) {
+        FILE *fp;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        fp = fopen(path, "r");
+        if (!fp) break;
+        if (fgets(buf, sizeof(buf), fp)) parse_cpulist(buf, node);
+        fclose(fp);
+    }
+    nnodes = node > 0 ? node : 1;
+    if (node == 0) node_cpus[0] = (short)ncpus;
+}
+
+static void topo_init(void)
+{
+    pthread_once(&topo_once, topo_read);
+}
+
+int topo_cpus(void)  { topo_init(); return ncpus; }
+int topo_nodes(void) { topo_init(); return nnodes; }
+
+int topo_node_of_cpu(int cpu)
+{
+    topo_init();
+    return (cpu >= 0 && cpu < TOPO_MAX_CPUS) ? cpu_node[cpu] : 0;
+}
+
+int topo_cpu_for_worker(int worker, int mode)
+{
+    int target_node, rank, cpu;
+
+    topo_init();
+    worker %= ncpus;
+
+    if (nnodes == 1) return worker;
+
+    // compact: fill node 0, then node 1, ...; CPU numbers of a node need
+    // not be contiguous (interleaved numbering on two-socket machines)
+    if (mode == TOPO_PIN_COMPACT) {
+        rank = worker;
+        for (target_node = 0; target_node < nnodes; target_node++)
+            for (cpu = 0; cpu < ncpus; cpu++)
+                if (cpu_node[cpu] == target_node && rank-- == 0) return cpu;
+        return worker;
+    }
+
+    // spread: worker k goes to node k % nnodes, the (k / nnodes)-th CPU there
+    target_node = worker % nnodes;
+    rank = (worker / nnodes) % (node_cpus[target_node] > 0 ? node_cpus[target_node] : 1);
+    for (cpu = 0; cpu < ncpus; cpu++)
+        if (cpu_node[cpu] == target_node && rank-- == 0) return cpu;
+    return worker;
+}
+
+int topo_parse_pin(const char *s)
+{
+    if (!s) s = getenv("TOOLBOX_PIN");
+    if (!s) return TOPO_PIN_NONE;
+    if (strcmp(s, "compact") == 0) return TOPO_PIN_COMPACT;
+    if (strcmp(s, "spread") == 0) return TOPO_PIN_SPREAD;
+    return TOPO_PIN_NONE;
+}
+
+int topo_current_node(void)
+{
+    int cpu = sched_getcpu();
+    return topo_node_of_cpu(cpu < 0 ? 0 : cpu);
+}
+
+void *topo_alloc(size_t bytes)
+{
+    void *p = mmap(NULL, bytes ? bytes : 1, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return (p == MAP_FAILED) ? NULL : p;
+}
+
+void topo_free(void *p, size_t bytes)
+{
+    if (p) munmap(p, bytes ? bytes : 1);
+}
+
+typedef struct {
+    char  *base;
+    size_t elem_size;
+} touch_job;
+
+static void touch_chunk(size_t lo, size_t hi, void *arg)
+{
+    const touch_job *j = arg;
+    memset(j->base + lo * j->elem_size, 0, (hi - lo) * j->elem_size);
+}
+
+void topo_first_touch(void *p, size_t elem_size, size_t n)
+{
+    touch_job job;
+
+    job.base = p;
+    job.elem_size = elem_size;
+    parallel_for_static(0, n, touch_chunk, &job);
+}
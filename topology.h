@@ -0,0 +1,41 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <stddef.h>
+
+// CPU / NUMA topology and first-touch memory placement
+// Read from Linux sysfs, so no libnuma is needed. On other systems (or
+// without sysfs) everything is reported as one node.
+
+#define TOPO_MAX_CPUS  1024
+#define TOPO_MAX_NODES 64
+
+// Pinning modes for worker threads
+#define TOPO_PIN_NONE     0   // let the OS place threads
+#define TOPO_PIN_COMPACT  1   // fill node 0 first, then node 1, ...
+#define TOPO_PIN_SPREAD   2   // round-robin over nodes
+
+int topo_cpus(void);
+int topo_nodes(void);
+int topo_node_of_cpu(int cpu);
+
+// CPU that worker number `worker` should be pinned to in a pinning mode
+int topo_cpu_for_worker(int worker, int mode);
+
+// Pinning mode from TOOLBOX_PIN (none/compact/spread) or a string
+int topo_parse_pin(const char *s);
+
+// Node the calling thread is currently running on
+int topo_current_node(void);
+
+// Page-aligned memory whose pages are not touched yet, so the first
+// thread to write a page decides which node it lives on
+void *topo_alloc(size_t bytes);
+void  topo_free(void *p, size_t bytes);
+
+// Zeroes n elements of elem_size bytes using the scheduler's static
+// partition, so each page lands on the node of the worker that will
+// later process it with parallel_for_static()
+void  topo_first_touch(void *p, size_t elem_size, size_t n);
+
+#endif
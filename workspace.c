@@ -0,0 +1,181 @@
+// Session workspace
+// Open-addressing hash table (FNV-1a, linear probing) of named values.
+// Names and array data live in one arena that is released by ws_clear().
+// Arrays are overwritten in place when the new data fits their capacity.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "workspace.h"
+
+#define WS_ARENA_BLOCK (1 << 20)
+
+static ws_entry ws_table[WS_SLOTS];
+static int      ws_used;
+static arena_t  ws_arena = ARENA_INIT(WS_ARENA_BLOCK);
+
+static unsigned ws_hash(const char *s, int len)
+{
+    unsigned h = 2166136261u;
+    int i;
+    for (i = 0; i < len; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+int ws_slot(const char *name, int len, int create)
+{
+    unsigned i = ws_hash(name, len) & (WS_SLOTS - 1);
+
+    if (len <= 0 || len > WS_NAME_MAX) return -1;
+
+    for (;;) {
+        ws_entry *e = &ws_table[i];
+
+        if (!e->name) {
+            // keep the table at most 3/4 full so probes stay short
+            if (!create || ws_used >= WS_SLOTS * 3 / 4) return -1;
+            e->name = arena_strdup(&ws_arena, name, len);
+            if (!e->name) return -1;
+            ws_used++;
+            return (int)i;
+        }
+        if (strncmp(e->name, name, len) == 0 && e->name[len] == '\0') return (int)i;
+
+        i = (i + 1) & (WS_SLOTS - 1);
+    }
+}
+
+ws_entry *ws_at(int slot)
+{
+    return &ws_table[slot];
+}
+
+// Makes sure the slot has room for n doubles
+static int ws_reserve(ws_entry *e, int n)
+{
+    if (e->v && e->cap >= n) return 0;
+    e->v = arena_alloc(&ws_arena, sizeof(double) * (n > 0 ? n : 1));
+    if (!e->v) { e->cap = 0; return -1; }
+    e->cap = n;
+    return 0;
+}
+
+int ws_store(int slot, double x, const double *data, int n)
+{
+    ws_entry *e = &ws_table[slot];
+
+    if (data) {
+        // data may be this slot's own array (x = x)
+        if (data != e->v && ws_reserve(e, n) != 0) return -1;
+        memmove(e->v, data, sizeof(double) * n);
+        e->n = n;
+        e->array = 1;
+    } else {
+        e->x = x;
+        e->array = 0;
+    }
+    e->defined = 1;
+    return 0;
+}
+
+int ws_set_value(const char *name, double x)
+{
+    int slot = ws_slot(name, (int)strlen(name), 1);
+    if (slot < 0) return -1;
+    return ws_store(slot, x, NULL, 0);
+}
+
+int ws_set_array(const char *name, const double *data, int n)
+{
+    int slot = ws_slot(name, (int)strlen(name), 1);
+    if (slot < 0) return -1;
+    return ws_store(slot, 0.0, data, n);
+}
+
+double *ws_alloc_array(const char *name, int n)
+{
+    int slot = ws_slot(name, (int)strlen(name), 1);
+    ws_entry *e;
+
+    if (slot < 0) return NULL;
+    e = &ws_table[slot];
+    if (ws_reserve(e, n) != 0) return NULL;
+    e->n = n;
+    e->array = 1;
+    e->defined = 1;
+    return e->v;
+}
+
+int ws_get_value(const char *name, double *x)
+{
+    int slot = ws_slot(name, (int)strlen(name), 0);
+    if (slot < 0 || !ws_table[slot].defined || ws_table[slot].array) return -1;
+    *x = ws_table[slot].x;
+    return 0;
+}
+
+const double *ws_get_array(const char *name, int *n)
+{
+    int slot = ws_slot(name, (int)strlen(name), 0);
+    if (slot < 0 || !ws_table[slot].defined || !ws_table[slot].array) return NULL;
+    *n = ws_table[slot].n;
+    return ws_table[slot].v;
+}
+
+int ws_load_file(const char *name, const char *path)
+{
+    char line[256];
+    double *data;
+    int count = 0, i = 0;
+    FILE *fp = fopen(path, "r");
+
+    if (!fp) return -1;
+
+    // first pass counts numeric lines so the array is allocated once
+    while (fgets(line, sizeof(line), fp)) {
+        char *end;
+        strtod(line, &end);
+        if (end != line) count++;
+    }
+
+    data = ws_alloc_array(name, count);
+    if (!data) { fclose(fp); return -1; }
+
+    rewind(fp);
+    while (i < count && fgets(line, sizeof(line), fp)) {
+        char *end;
+        double v = strtod(line, &end);
+        if (end != line) data[i++] = v;
+    }
+    fclose(fp);
+    return i;
+}
+
+void ws_list(FILE *out)
+{
+    int i, j;
+
+    for (i = 0; i < WS_SLOTS; i++) {
+        const ws_entry *e = &ws_table[i];
+        if (!e->name || !e->defined) continue;
+
+        if (!e->array) {
+            fprintf(out, "%s = %.6g\n", e->name, e->x);
+            continue;
+        }
+        fprintf(out, "%s = [", e->name);
+        for (j = 0; j < e->n && j < 8; j++) fprintf(out, "%s%.6g", j ? ", " : "", e->v[j]);
+        fprintf(out, "%s] (%d values)\n", e->n > 8 ? ", ..." : "", e->n);
+    }
+}
+
+void ws_clear(void)
+{
+    memset(ws_table, 0, sizeof(ws_table));
+    ws_used = 0;
+    arena_reset(&ws_arena);
+}
@@ -0,0 +1,46 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <stdio.h>
+
+// Session workspace
+// Named scalars and arrays shared by every module and the REPL, so a result
+// from one calculation can be reused in the next without typing it again.
+// Storage comes from one arena and names are found through a hash table.
+
+#define WS_SLOTS    1024   // hash table size (power of two)
+#define WS_NAME_MAX 31
+
+typedef struct {
+    const char *name;      // NULL = free slot
+    int         defined;   // slot reserved but no value yet = 0
+    int         array;     // 1 = v/n hold the value, 0 = x does
+    double      x;         // scalar value
+    double     *v;         // array storage (kept when a scalar is stored)
+    int         n, cap;    // array length and allocated capacity
+} ws_entry;
+
+// Slot index for a name (create = reserve a slot if missing), -1 if none
+int ws_slot(const char *name, int len, int create);
+ws_entry *ws_at(int slot);
+
+// Store/fetch by name, 0 on success, -1 if missing or out of memory
+int ws_set_value(const char *name, double x);
+int ws_set_array(const char *name, const double *data, int n);
+int ws_get_value(const char *name, double *x);
+const double *ws_get_array(const char *name, int *n);
+
+// Store into an existing slot (used by the REPL), data may be NULL for a scalar
+int ws_store(int slot, double x, const double *data, int n);
+
+// Allocates an array in place (no copy) for large data, NULL on failure
+double *ws_alloc_array(const char *name, int n);
+
+// Reads one number per line (first column) of a text file into an array
+// Returns the number of values or -1 on error
+int ws_load_file(const char *name, const char *path);
+
+void ws_list(FILE *out);
+void ws_clear(void);
+
+#endif